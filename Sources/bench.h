@@ -0,0 +1,56 @@
+/*
+ * DotMatrixClock2018/bench.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+// Benchmark markers for Tools/bench;
+// ... with BENCHMARK defined on target, markers are written to general
+// ... purpose I/O registers (1 cycle each) and timestamped by the simulator.
+// ... Interrupts are timed by the simulator itself without markers
+
+// Marker codes written to GPIOR0
+enum {
+    BENCH_MARK_LOOP = 0x01,
+    BENCH_MARK_TASK = 0x02,
+    BENCH_MARK_TASK_END = 0x03,
+    BENCH_MARK_FRAME = 0x04,
+    BENCH_MARK_BOOT_DONE = 0x05
+};
+
+#if defined(BENCHMARK) && defined(__AVR__)
+
+#include <avr/io.h>
+
+// Mark the start of a main loop pass with the current state in GPIOR1
+#define bench_loop(state) \
+    do { GPIOR1 = (state); GPIOR0 = BENCH_MARK_LOOP; } while (0)
+// Mark the start of a task with its ID in GPIOR1 and latency in GPIOR2
+#define bench_task(id, latency) \
+    do { \
+        GPIOR2 = (latency); GPIOR1 = (id); GPIOR0 = BENCH_MARK_TASK; \
+    } while (0)
+// Mark the end of a task
+#define bench_task_end() \
+    do { GPIOR0 = BENCH_MARK_TASK_END; } while (0)
+// Mark a frame shown by the display ISR, and the end of startup
+#define bench_frame() \
+    do { GPIOR0 = BENCH_MARK_FRAME; } while (0)
+#define bench_boot_done() \
+    do { GPIOR0 = BENCH_MARK_BOOT_DONE; } while (0)
+
+#else
+
+#define bench_loop(state)
+#define bench_task(id, latency)
+#define bench_task_end()
+#define bench_frame()
+#define bench_boot_done()
+
+#endif
+
+#endif
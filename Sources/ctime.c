@@ -26,7 +26,7 @@ uint8_t days_in_month(ctime_t* ct) {
     if (ct->mo == 2) {
         // Leap year check if it is February
         days = 28 + is_leap_year(ct);
-    } else if (ct->mo == 0 || ct->mo >= 12) {
+    } else if (ct->mo == 0 || ct->mo > 12) {
         days = 0;
     } else {
         days = DAYS_IN_MONTH_TABLE[ct->mo - 1];
@@ -41,32 +41,39 @@ uint8_t days_in_month(ctime_t* ct) {
 // ...    <1>    one if carry occurs in seconds
 // ...    <0>    one if carry occurs in sub-seconds
 inline uint8_t ctime_increment_tick(ctime_t* ct) {
-    uint8_t result = 0;
-    
     if (ct->ms >= 999) {
-        result |= (1 << 0);
         ct->ms = 0;
-        if (ct->s >= 59) {
-            result |= (1 << 1);
-            ct->s = 0;
-            if (ct->m >= 59) {
-                result |= (1 << 2);
-                ct->m = 0;
-                if (ct->h >= 23) {
-                    result |= (1 << 3);
-                    ct->h = 0;
-                    result |= ctime_increment_day(ct);
-                } else {
-                    ct->h++;
-                }
+        return ctime_increment_second(ct);
+    } else {
+        ct->ms++;
+        return 0;
+    }
+}
+
+// Increment clock time by one second, leaving sub-seconds as they are;
+// ... return carries in the same bits as ctime_increment_tick(), where
+// ... bit<0> is always one
+inline uint8_t ctime_increment_second(ctime_t* ct) {
+    uint8_t result = (1 << 0);
+    
+    if (ct->s >= 59) {
+        result |= (1 << 1);
+        ct->s = 0;
+        if (ct->m >= 59) {
+            result |= (1 << 2);
+            ct->m = 0;
+            if (ct->h >= 23) {
+                result |= (1 << 3);
+                ct->h = 0;
+                result |= ctime_increment_day(ct);
             } else {
-                ct->m++;
+                ct->h++;
             }
         } else {
-            ct->s++;
+            ct->m++;
         }
     } else {
-        ct->ms++;
+        ct->s++;
     }
     return result;
 }
@@ -175,6 +182,19 @@ uint8_t ctime_check_error(ctime_t* ct) {
     return result;
 }
 
+// Force set UTC time to local time of JST (UTC+9); the day is carried
+// ... when the date is also taken
+void ctime_localize(ctime_t* ct, bool date) {
+    if (ct->h + 9 >= 24) {
+        ct->h = ct->h + 9 - 24;
+        if (date) {
+            ctime_increment_day(ct);
+        }
+    } else {
+        ct->h += 9;
+    }
+}
+
 // Calculate week-of-day applying Zeller's congruence
 // ... https://en.wikipedia.org/wiki/Zeller%27s_congruence
 dow_t dayofweek(ctime_t* ct) {
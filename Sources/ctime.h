@@ -40,9 +40,11 @@ typedef enum {
 uint8_t is_leap_year(ctime_t* ct);
 uint8_t days_in_month(ctime_t* ct);
 uint8_t ctime_increment_tick(ctime_t* ct);
+uint8_t ctime_increment_second(ctime_t* ct);
 uint8_t ctime_increment_day(ctime_t* ct);
 uint8_t ctime_decrement_day(ctime_t* ct);
 uint8_t ctime_check_error(ctime_t* ct);
+void ctime_localize(ctime_t* ct, bool date);
 dow_t dayofweek(ctime_t* ct);
 
 #endif
@@ -8,19 +8,32 @@
 #ifndef DEFS_DOTMATRIXCLOCK2018_H_
 #define DEFS_DOTMATRIXCLOCK2018_H_
 
-// USART receiver buffer length
-#define RX_BUFFER_LENGTH                   32
-// USART transmitter buffer length
+// USART receiver buffer length; holds 11 ms of input at 115200 baud for
+// ... the main loop to catch up
+#define RX_BUFFER_LENGTH                  128
+// USART transmitter buffer length; trace builds leave room for a trace
+// ... line besides a serial message
+#ifdef TRACE
+#define TX_BUFFER_LENGTH                   64
+#else
 #define TX_BUFFER_LENGTH                   32
+#endif
+#if (RX_BUFFER_LENGTH & (RX_BUFFER_LENGTH - 1)) || RX_BUFFER_LENGTH > 128 || \
+    (TX_BUFFER_LENGTH & (TX_BUFFER_LENGTH - 1)) || TX_BUFFER_LENGTH > 128
+#error "USART buffer lengths must be powers of 2 up to 128"
+#endif
 
-// GPS NMEA message buffer length
-#define MESSAGE_BUFFER_LENGTH             192
+// Maximum length of message text received from serial input
+#define MESSAGE_TEXT_LENGTH                32
 
 // EEPROM address map
 #define EEREDUN_CONFIG_REDUNDANCY           7
 #define EEREDUN_CONFIG_STRIDE             128
 #define EEREDUN_CONFIG_BASE_TIMESTAMP  0x0010
 #define EEREDUN_CONFIG_BASE_ENTITY     0x0080
+// Version of configuration byte array, stored in its last byte;
+// ... blobs of older firmware have 0xff there
+#define CONFIG_BLOB_VERSION                 1
 
 // Number of event entries per item
 #define NUM_EVENT_ENTRIES_PER_ITEM          8
@@ -30,26 +43,39 @@
 #define T5_READ_TEMPERATURE_INTERVAL_MS   600
 #define T5_DRAW_SCREEN_INTERVAL_MS         20
 #define T5_GET_LIGHT_LEVEL_INTERVAL_MS    200
+#define T5_BOOT_INTERVAL_MS                 2
+#define T5_AUTOBAUD_INTERVAL_MS           100
+
+// Display brightness setting for automatic leveling by light sensor
+#define BRIGHTNESS_AUTO      (BRIGHTNESS_MAX + 1)
+
+// Marquee timing in frames of T5_DRAW_SCREEN_INTERVAL_MS;
+// ... 2 frames per dot = 25 dots per second, 50 frames = 1 second pause
+#define MARQUEE_SPEED_FRAMES                2
+#define MARQUEE_PAUSE_FRAMES               50
 
 // Retry count for reading RTC on startup
 #define RETRY_COUNT_READ_RTC_ON_STARTUP    10
 
+// Stages of startup finished by T5_BOOT after the first frame
+typedef enum {
+    BOOT_READ_RTC,
+    BOOT_RESTORE_CONFIG,
+    BOOT_SETUP_SENSOR,
+    BOOT_CHECK_RELAYS,
+    BOOT_DONE
+} boot_t;
+
 // Receiver timeout to GPS connection loss
 #define GPS_CONNECTION_LOST_TIMEOUT_MS   5000
 
-// T5 task
-typedef struct {
-    // Trigger interval in ticks 
-    uint32_t interval;
-    // Timestamp of last execution in ticks
-    uint32_t timestamp;
-} task5_t;
-
-// T6 task
-typedef struct {
-    // Pending flag
-    bool pending;
-} task6_t;
+// USART baud rate when not configured (usart_rate_t)
+#define USART_RATE_DEFAULT        USART_9600
+// Auto-baud detection on GPS input; a rate is given up when input comes
+// ... without any sentence or frame validated for the time, or earlier by
+// ... the count of frame errors
+#define AUTOBAUD_DWELL_MS                2500
+#define AUTOBAUD_FRAME_ERRORS              16
 
 // Enumeration table for states
 typedef enum {
@@ -59,6 +85,7 @@ typedef enum {
     ST_NORMAL_DATE_YEARS             = 0x08,
     ST_NORMAL_TEMPERATURE            = 0x0c,
     ST_NORMAL_GPS_STATUS             = 0x10,
+    ST_NORMAL_MESSAGE                = 0x14,
     ST_CONFIG_USE_GPS                = 0x20,
     ST_CONFIG_SET_TIME_TOP           = 0x21,
     ST_CONFIG_SET_TIME_MOD_YH        = 0x40,
@@ -94,6 +121,44 @@ enum {
     ST_NORMAL_UPPER_MASK = 0xfc
 };
 
+// Bit flags of inputs which screens depend on
+enum {
+    DEP_CLOCK_HM    = 0x01,
+    DEP_CLOCK_S     = 0x02,
+    DEP_DATE        = 0x04,
+    DEP_BLINKER     = 0x08,
+    DEP_TEMPERATURE = 0x10,
+    DEP_GPS         = 0x20,
+    DEP_LIGHT_ADC   = 0x40,
+    DEP_MESSAGE     = 0x80
+};
+
+// Snapshot of inputs drawn on the screen;
+// ... members not depended on by the current screen are left zero
+typedef struct {
+    // Status which selects the screen
+    uint8_t status;
+    // Clock digits including their scroll states
+    cdigit_t cd[6];
+    // Clock date
+    uint8_t yh, yl, mo, d, dow;
+    // Blinker phase of the element under modification
+    bool blinker;
+    // Temperature status
+    bool temperature_result;
+    uint8_t temperature_sign;
+    uint8_t temperature_integer;
+    uint16_t temperature_fraction_x10k;
+    // GPS status, blink phase and marquee steps of its tracking indicator
+    uint8_t gps_status;
+    uint8_t gps_blink_phase;
+    uint8_t gps_marquee_steps;
+    // Marquee steps of message text
+    uint8_t message_marquee_steps;
+    // ADC value of light sensor
+    uint16_t light_adc;
+} screen_inputs_t;
+
 // Enumeration table of GPS states
 typedef enum {
     GP_ABSENT   = 0xff,
@@ -102,6 +167,15 @@ typedef enum {
     GP_DGPS_FIX = 0x02
 } gpstate_t;
 
+// Enumeration table of GPS clock sources, in order of preference
+typedef enum {
+    GS_NONE,
+    GS_NMEA_RMC,
+    GS_NMEA_ZDA,
+    GS_UBX_NAV_TIMEUTC,
+    GS_UBX_NAV_PVT
+} gps_source_t;
+
 // Configuration structure
 typedef struct {
     // State on startup
@@ -115,8 +189,11 @@ typedef struct {
         // Event entries
         event_t ev[NUM_EVENT_ENTRIES_PER_ITEM];
     } relay[3];
-    // Display brightness (1..4: fixed, 5..: automatic)
+    // Display brightness (1..BRIGHTNESS_MAX: fixed, BRIGHTNESS_AUTO: automatic)
     uint8_t brightness;
+    // USART baud rate (usart_rate_t); detected on GPS input while GPS is
+    // ... used, and saved when found
+    uint8_t usart_rate;
 } config_t;
 
 #endif
@@ -25,10 +25,76 @@ enum {
     FONT_MASK = 0xf0
 };
 
+// Packing of glyph lines in program memory
+typedef enum {
+    // A line per byte
+    GLYPH_BYTES,
+    // 2 lines per byte, upper nibble first
+    GLYPH_NIBBLES,
+    // 5 lines of up to 5 dots in 4 bytes, see Tools/fontc.py
+    GLYPH_QUINTS
+} glyph_packing_t;
+
+// Glyph of a character
+typedef struct {
+    // First bitmap line in program memory
+    const uint8_t* bitmap;
+    // Width in dots
+    uint8_t width;
+    // Height in dots
+    uint8_t height;
+    // Packing of lines (glyph_packing_t)
+    uint8_t packing;
+} glyph_t;
+
+// String alignment to the specified column
+typedef enum {
+    ALIGN_LEFT,
+    ALIGN_RIGHT,
+    ALIGN_CENTER
+} align_t;
+
+// Maximum display brightness level; duty ratio is level / BRIGHTNESS_MAX
+#define BRIGHTNESS_MAX  15
+
+// Binary code modulation of display brightness;
+// ... bit-plane of weight W lasts W units, one line takes 4 bit-planes
+// ... 20e+6[Hz(CPU)] / 64[prescaler] / 21[counts] = 67.2 us per unit,
+// ... 15 units = 1.008 ms per line, 16 lines = 62.0 Hz refresh rate,
+// ... 3968 interrupts per second
+#define BCM_UNIT_COUNTS  21
+#define BCM_MAX_WEIGHT    8
+
+// PORTD bits in serialized scan line data
+// ... PD2: line driver (set on the clock for its own line)
+// ... PD3: column driver for left half
+// ... PD4: column driver for right half
+#define SCAN_BIT_LINE   (1 << 2)
+#define SCAN_BIT_LEFT   (1 << 3)
+#define SCAN_BIT_RIGHT  (1 << 4)
+
+// Serialized scan line; PORTD data bytes sent to the display module
+typedef struct {
+    // Whether the line has no dots to light
+    bool blank;
+    // PORTD data for each of 16 serial clocks (SIN1..SIN3 bits only)
+    uint8_t data[16];
+} scanline_t;
+
+uint8_t font_find_glyph(const uint8_t* ranges, uint8_t count, uint8_t c);
+void display_get_glyph(font_t f, uint8_t c, glyph_t* g);
+uint8_t display_glyph_line(glyph_t* g, uint8_t i);
 void display_clear();
 void display_sync();
+void display_flip();
 void display_putc(font_t f, uint8_t x, uint8_t y, uint8_t c);
 void display_putc_scroll(font_t f, uint8_t x, uint8_t y, uint8_t c_ex,
     uint8_t c_new, uint8_t frame);
+void display_puts_generic(font_t f, uint8_t x, uint8_t y, align_t align,
+    const char* s, bool progmem);
+void display_puts(font_t f, uint8_t x, uint8_t y, align_t align,
+    const char* s);
+void display_puts_P(font_t f, uint8_t x, uint8_t y, align_t align,
+    const char* s);
 
 #endif
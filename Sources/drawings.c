@@ -7,9 +7,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <avr/pgmspace.h>
 #include "ctime.h"
 #include "event.h"
 #include "display.h"
+#include "marquee.h"
 #include "drawings.h"
 
 extern volatile uint32_t gbuf_back[16];
@@ -23,6 +25,20 @@ cdigit_t cd[6] = {
     { ' ', ' ', 0 }
 };
 
+// Month name strings; index 0 is for invalid months
+PROGMEM char const month_names[13][4] = {
+    "---", "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+// Day-of-week name strings; index 0 is unused
+PROGMEM char const dow_names[8][4] = {
+    "", "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
+// GPS fix quality strings; index 0 (not fixed) is drawn separately
+PROGMEM char const gps_fix_names[9][8] = {
+    "", "GPS", "DGPS", "PPS", "RTK", "Fl.RTK", "D.Reck.", "Manual", "Simul."
+};
+
 // Update clock digits to internal clock time
 void update_cdigit(ctime_t* ct) {
     // Set characters, hour high digit is zero-suppressed
@@ -79,8 +95,9 @@ void update_cdigit_with_scroll(ctime_t* ct) {
     }
 }
 
-// Draw clock time in "{hours}:{minutes}" format (no second digits)
-void draw_time_hm(ctime_t* ct, uint16_t mask) {
+// Draw clock time in "{hours}:{minutes}" format (no second digits);
+// ... clock digits are to be updated by update_cdigit_with_scroll()
+void draw_time_hm(uint16_t mask) {
     // Bit mask of drawable elements
     //   mask<15>    reserved
     //       <14>    colon
@@ -97,8 +114,6 @@ void draw_time_hm(ctime_t* ct, uint16_t mask) {
     uint8_t const y_list[4] = { 6, 6, 6, 6 };
     uint8_t const mask_list[4] = { 7, 7, 6, 5 };
 
-    // Update clock characters' scroll states
-    update_cdigit_with_scroll(ct);
     // Draw colon
     if (mask & (1 << 14)) {
         display_putc(FONT_M0410, 16, 6, ':');
@@ -112,8 +127,9 @@ void draw_time_hm(ctime_t* ct, uint16_t mask) {
     }
 }
 
-// Draw clock time in "{hours}:{minutes} {seconds}" format
-void draw_time_hms(ctime_t* ct, uint16_t mask) {
+// Draw clock time in "{hours}:{minutes} {seconds}" format;
+// ... clock digits are to be updated by update_cdigit_with_scroll()
+void draw_time_hms(uint16_t mask) {
     // Bit mask of drawable elements
     //   mask<15>    reserved
     //       <14>    colon
@@ -133,8 +149,6 @@ void draw_time_hms(ctime_t* ct, uint16_t mask) {
     uint8_t const y_list[6] = { 6, 6, 6, 6, 11, 11 };
     uint8_t const mask_list[6] = { 7, 7, 6, 5, 4, 3 };
 
-    // Update clock characters' scroll states
-    update_cdigit_with_scroll(ct);
     // Draw colon
     if (mask & (1 << 14)) {
         display_putc(FONT_M0410, 21, 6, ':');
@@ -182,43 +196,8 @@ void draw_date_dayofweek(ctime_t* ct, dow_t dow, uint16_t mask) {
     }
     // Draw day-of-week string
     if (mask & (1 << 8)) {
-        switch (dow) {
-        case DOW_SUNDAY:
-            display_putc(FONT_PP05, 10, 0, 'S');
-            display_putc(FONT_PP05, 6, 0, 'u');
-            display_putc(FONT_PP05, 2, 0, 'n');
-            break;
-        case DOW_MONDAY:
-            display_putc(FONT_PP05, 12, 0, 'M');
-            display_putc(FONT_PP05, 6, 0, 'o');
-            display_putc(FONT_PP05, 2, 0, 'n');
-            break;
-        case DOW_TUESDAY:
-            display_putc(FONT_PP05, 10, 0, 'T');
-            display_putc(FONT_PP05, 6, 0, 'u');
-            display_putc(FONT_PP05, 2, 0, 'e');
-            break;
-        case DOW_WEDNESDAY:
-            display_putc(FONT_PP05, 12, 0, 'W');
-            display_putc(FONT_PP05, 6, 0, 'e');
-            display_putc(FONT_PP05, 2, 0, 'd');
-            break;
-        case DOW_THURSDAY:
-            display_putc(FONT_PP05, 10, 0, 'T');
-            display_putc(FONT_PP05, 6, 0, 'h');
-            display_putc(FONT_PP05, 2, 0, 'u');
-            break;
-        case DOW_FRIDAY:
-            display_putc(FONT_PP05, 7, 0, 'F');
-            display_putc(FONT_PP05, 3, 0, 'r');
-            display_putc(FONT_PP05, 0, 0, 'i');
-            break;
-        case DOW_SATURDAY:
-            display_putc(FONT_PP05, 9, 0, 'S');
-            display_putc(FONT_PP05, 5, 0, 'a');
-            display_putc(FONT_PP05, 1, 0, 't');
-            break;
-        }
+        display_puts_P(FONT_PP05, 0, 0, ALIGN_RIGHT,
+            dow_names[dow <= DOW_SATURDAY ? dow : 0]);
     }
 }
 
@@ -237,73 +216,8 @@ void draw_date_year(ctime_t* ct, uint16_t mask) {
 
     // Draw month string
     if (mask & (1 << 10)) {
-        switch (ct->mo) {
-        case 1:  // Jan
-            display_putc(FONT_PP05, 31, 0, 'J');
-            display_putc(FONT_PP05, 27, 0, 'a');
-            display_putc(FONT_PP05, 23, 0, 'n');
-            break;
-        case 2:  // Feb
-            display_putc(FONT_PP05, 31, 0, 'F');
-            display_putc(FONT_PP05, 27, 0, 'e');
-            display_putc(FONT_PP05, 23, 0, 'b');
-            break;
-        case 3:  // Mar
-            display_putc(FONT_PP05, 31, 0, 'M');
-            display_putc(FONT_PP05, 25, 0, 'a');
-            display_putc(FONT_PP05, 21, 0, 'r');
-            break;
-        case 4:  // Apr
-            display_putc(FONT_PP05, 31, 0, 'A');
-            display_putc(FONT_PP05, 27, 0, 'p');
-            display_putc(FONT_PP05, 23, 0, 'r');
-            break;
-        case 5:  // May
-            display_putc(FONT_PP05, 31, 0, 'M');
-            display_putc(FONT_PP05, 25, 0, 'a');
-            display_putc(FONT_PP05, 21, 0, 'y');
-            break;
-        case 6:  // Jun
-            display_putc(FONT_PP05, 31, 0, 'J');
-            display_putc(FONT_PP05, 27, 0, 'u');
-            display_putc(FONT_PP05, 23, 0, 'n');
-            break;
-        case 7:  // Jul
-            display_putc(FONT_PP05, 31, 0, 'J');
-            display_putc(FONT_PP05, 27, 0, 'u');
-            display_putc(FONT_PP05, 23, 0, 'l');
-            break;
-        case 8:  // Aug
-            display_putc(FONT_PP05, 31, 0, 'A');
-            display_putc(FONT_PP05, 27, 0, 'u');
-            display_putc(FONT_PP05, 23, 0, 'g');
-            break;
-        case 9:  // Sep
-            display_putc(FONT_PP05, 31, 0, 'S');
-            display_putc(FONT_PP05, 27, 0, 'e');
-            display_putc(FONT_PP05, 23, 0, 'p');
-            break;
-        case 10:  // Oct
-            display_putc(FONT_PP05, 31, 0, 'O');
-            display_putc(FONT_PP05, 27, 0, 'c');
-            display_putc(FONT_PP05, 23, 0, 't');
-            break;
-        case 11:  // Nov
-            display_putc(FONT_PP05, 31, 0, 'N');
-            display_putc(FONT_PP05, 26, 0, 'o');
-            display_putc(FONT_PP05, 22, 0, 'v');
-            break;
-        case 12:  // Dec
-            display_putc(FONT_PP05, 31, 0, 'D');
-            display_putc(FONT_PP05, 27, 0, 'e');
-            display_putc(FONT_PP05, 23, 0, 'c');
-            break;
-        default:
-            display_putc(FONT_PP05, 31, 0, '-');
-            display_putc(FONT_PP05, 27, 0, '-');
-            display_putc(FONT_PP05, 23, 0, '-');
-            break;
-        }
+        display_puts_P(FONT_PP05, 31, 0, ALIGN_LEFT,
+            month_names[ct->mo <= 12 ? ct->mo : 0]);
     }
     // Draw days
     if (mask & (1 << 9)) {
@@ -375,15 +289,14 @@ void draw_temperature(bool result, uint8_t sign, uint8_t integer,
             display_putc(FONT_PP05, 6, 0, '\177');
             display_putc(FONT_PP05, 3, 0, 'C');
         } else {
-            display_putc(FONT_PP05, 11, 0, '-');
-            display_putc(FONT_PP05, 7, 0, '-');
-            display_putc(FONT_PP05, 3, 0, '-');
+            display_puts_P(FONT_PP05, 1, 0, ALIGN_RIGHT, PSTR("---"));
         }                            
     }
 }
 
 // Draw GPS tracking status
-void draw_gps_status(uint8_t fix, uint8_t blink_phase, uint16_t mask) {
+void draw_gps_status(uint8_t fix, uint8_t blink_phase, marquee_t* mq,
+    uint16_t mask) {
     // Bit mask of drawable elements
     //   mask<15:3>  reserved
     //       <2>     GPS tracking status "No GPS"/"Unfixed"/"2D fix"/"3D fix"
@@ -393,85 +306,36 @@ void draw_gps_status(uint8_t fix, uint8_t blink_phase, uint16_t mask) {
     if (mask & (1 << 2)) {
         switch (fix) {
         case 0xff:
-            display_putc(FONT_PP05, 31, 0, '-');
-            display_putc(FONT_PP05, 27, 0, '-');
-            display_putc(FONT_PP05, 23, 0, '-');
+            display_puts_P(FONT_PP05, 31, 0, ALIGN_LEFT, PSTR("---"));
             break;
         case 0x00:
             display_putc(FONT_PP05, 31, 0, '\232' + blink_phase);
-            display_putc(FONT_PP05, 28, 0, '\226');
-            display_putc(FONT_PP05, 20, 0, '\227');
-            display_putc(FONT_PP05, 12, 0, '\230');
-            display_putc(FONT_PP05, 4, 0, '\231');
-            break;
-        case 0x01:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'G');
-            display_putc(FONT_PP05, 21, 0, 'P');
-            display_putc(FONT_PP05, 17, 0, 'S');
-            break;
-        case 0x02:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'D');
-            display_putc(FONT_PP05, 21, 0, 'G');
-            display_putc(FONT_PP05, 17, 0, 'P');
-            display_putc(FONT_PP05, 13, 0, 'S');
-            break;
-        case 0x03:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'P');
-            display_putc(FONT_PP05, 21, 0, 'P');
-            display_putc(FONT_PP05, 17, 0, 'S');
-            break;
-        case 0x04:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'R');
-            display_putc(FONT_PP05, 21, 0, 'T');
-            display_putc(FONT_PP05, 17, 0, 'K');
-            break;
-        case 0x05:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'F');
-            display_putc(FONT_PP05, 21, 0, 'l');
-            display_putc(FONT_PP05, 18, 0, '.');
-            display_putc(FONT_PP05, 15, 0, 'R');
-            display_putc(FONT_PP05, 11, 0, 'T');
-            display_putc(FONT_PP05, 7, 0, 'K');
-            break;
-        case 0x06:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'D');
-            display_putc(FONT_PP05, 21, 0, '.');
-            display_putc(FONT_PP05, 18, 0, 'R');
-            display_putc(FONT_PP05, 14, 0, 'e');
-            display_putc(FONT_PP05, 10, 0, 'c');
-            display_putc(FONT_PP05, 6, 0, 'k');
-            display_putc(FONT_PP05, 2, 0, '.');
-            break;
-        case 0x07:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'M');
-            display_putc(FONT_PP05, 19, 0, 'a');
-            display_putc(FONT_PP05, 15, 0, 'n');
-            display_putc(FONT_PP05, 11, 0, 'u');
-            display_putc(FONT_PP05, 7, 0, 'a');
-            display_putc(FONT_PP05, 3, 0, 'l');
-            break;
-        case 0x08:
-            display_putc(FONT_PP05, 33, 1, '\205');
-            display_putc(FONT_PP05, 25, 0, 'S');
-            display_putc(FONT_PP05, 21, 0, 'i');
-            display_putc(FONT_PP05, 19, 0, 'm');
-            display_putc(FONT_PP05, 13, 0, 'u');
-            display_putc(FONT_PP05, 9, 0, 'l');
-            display_putc(FONT_PP05, 6, 0, '.');
+            marquee_draw(mq, 0);
             break;
         default:
+            if (fix <= 0x08) {
+                display_putc(FONT_PP05, 33, 1, '\205');
+                display_puts_P(FONT_PP05, 25, 0, ALIGN_LEFT,
+                    gps_fix_names[fix]);
+            }
             break;
         }
     }
 }
 
+// Draw message text received from serial input
+void draw_message(marquee_t* mq, uint16_t mask) {
+    // Bit mask of drawable elements
+    //   mask<15:3>  reserved
+    //       <2>     message text
+    //       <1:0>   reserved
+
+    // Draw message text
+    if (mask & (1 << 2)) {
+        marquee_draw(mq, 0);
+    }
+}
+
 // Draw configuration screen USE_GPS
 void draw_config_use_gps(bool use_gps, uint16_t mask) {
     // Bit mask of drawable elements
@@ -492,12 +356,7 @@ void draw_config_use_gps(bool use_gps, uint16_t mask) {
     }
     // Draw caption string "Use GPS"
     if (mask & (1 << 2)) {
-        display_putc(FONT_PP05, 31, 5, 'U');
-        display_putc(FONT_PP05, 27, 5, 's');
-        display_putc(FONT_PP05, 23, 5, 'e');
-        display_putc(FONT_PP05, 17, 5, 'G');
-        display_putc(FONT_PP05, 13, 5, 'P');
-        display_putc(FONT_PP05, 9, 5, 'S');
+        display_puts_P(FONT_PP05, 31, 5, ALIGN_LEFT, PSTR("Use GPS"));
     }
     // Draw ballot box
     if (mask & (1 << 6)) {
@@ -505,14 +364,8 @@ void draw_config_use_gps(bool use_gps, uint16_t mask) {
     }
     // Draw value string "yes"/"no"
     if (mask & (1 << 5)) {
-        if (use_gps) {
-            display_putc(FONT_PP05, 10, 11, 'y');
-            display_putc(FONT_PP05, 6, 11, 'e');
-            display_putc(FONT_PP05, 2, 11, 's');
-        } else {
-            display_putc(FONT_PP05, 9, 11, 'n');
-            display_putc(FONT_PP05, 5, 11, 'o');
-        }
+        display_puts_P(FONT_PP05, 5, 11, ALIGN_CENTER,
+            use_gps ? PSTR("yes") : PSTR("no"));
     }
 }
 
@@ -533,21 +386,8 @@ void draw_config_set_time_top(uint16_t mask) {
     }
     // Draw caption string "Set time manually"
     if (mask & (1 << 2)) {
-        display_putc(FONT_PP05, 31, 5, 'S');
-        display_putc(FONT_PP05, 27, 5, 'e');
-        display_putc(FONT_PP05, 23, 5, 't');
-        display_putc(FONT_PP05, 19, 5, 't');
-        display_putc(FONT_PP05, 16, 5, 'i');
-        display_putc(FONT_PP05, 14, 5, 'm');
-        display_putc(FONT_PP05, 8, 5, 'e');
-        display_putc(FONT_PP05, 31, 11, 'm');
-        display_putc(FONT_PP05, 25, 11, 'a');
-        display_putc(FONT_PP05, 21, 11, 'n');
-        display_putc(FONT_PP05, 17, 11, 'u');
-        display_putc(FONT_PP05, 13, 11, 'a');
-        display_putc(FONT_PP05, 9, 11, 'l');
-        display_putc(FONT_PP05, 6, 11, 'l');
-        display_putc(FONT_PP05, 3, 11, 'y');
+        display_puts_P(FONT_PP05, 31, 5, ALIGN_LEFT, PSTR("Set time"));
+        display_puts_P(FONT_PP05, 31, 11, ALIGN_LEFT, PSTR("manually"));
     }
 }
 
@@ -579,73 +419,8 @@ void draw_config_set_time_mod(ctime_t* ct, dow_t dow, uint8_t icon_l,
     }
     // Draw month string
     if (mask & (1 << 10)) {
-        switch (ct->mo) {
-        case 1:  // Jan
-            display_putc(FONT_PP05, 31, 5, 'J');
-            display_putc(FONT_PP05, 27, 5, 'a');
-            display_putc(FONT_PP05, 23, 5, 'n');
-            break;
-        case 2:  // Feb
-            display_putc(FONT_PP05, 31, 5, 'F');
-            display_putc(FONT_PP05, 27, 5, 'e');
-            display_putc(FONT_PP05, 23, 5, 'b');
-            break;
-        case 3:  // Mar
-            display_putc(FONT_PP05, 31, 5, 'M');
-            display_putc(FONT_PP05, 25, 5, 'a');
-            display_putc(FONT_PP05, 21, 5, 'r');
-            break;
-        case 4:  // Apr
-            display_putc(FONT_PP05, 31, 5, 'A');
-            display_putc(FONT_PP05, 27, 5, 'p');
-            display_putc(FONT_PP05, 23, 5, 'r');
-            break;
-        case 5:  // May
-            display_putc(FONT_PP05, 31, 5, 'M');
-            display_putc(FONT_PP05, 25, 5, 'a');
-            display_putc(FONT_PP05, 21, 5, 'y');
-            break;
-        case 6:  // Jun
-            display_putc(FONT_PP05, 31, 5, 'J');
-            display_putc(FONT_PP05, 27, 5, 'u');
-            display_putc(FONT_PP05, 23, 5, 'n');
-            break;
-        case 7:  // Jul
-            display_putc(FONT_PP05, 31, 5, 'J');
-            display_putc(FONT_PP05, 27, 5, 'u');
-            display_putc(FONT_PP05, 23, 5, 'l');
-            break;
-        case 8:  // Aug
-            display_putc(FONT_PP05, 31, 5, 'A');
-            display_putc(FONT_PP05, 27, 5, 'u');
-            display_putc(FONT_PP05, 23, 5, 'g');
-            break;
-        case 9:  // Sep
-            display_putc(FONT_PP05, 31, 5, 'S');
-            display_putc(FONT_PP05, 27, 5, 'e');
-            display_putc(FONT_PP05, 23, 5, 'p');
-            break;
-        case 10:  // Oct
-            display_putc(FONT_PP05, 31, 5, 'O');
-            display_putc(FONT_PP05, 27, 5, 'c');
-            display_putc(FONT_PP05, 23, 5, 't');
-            break;
-        case 11:  // Nov
-            display_putc(FONT_PP05, 31, 5, 'N');
-            display_putc(FONT_PP05, 26, 5, 'o');
-            display_putc(FONT_PP05, 22, 5, 'v');
-            break;
-        case 12:  // Dec
-            display_putc(FONT_PP05, 31, 5, 'D');
-            display_putc(FONT_PP05, 27, 5, 'e');
-            display_putc(FONT_PP05, 23, 5, 'c');
-            break;
-        default:
-            display_putc(FONT_PP05, 31, 5, '-');
-            display_putc(FONT_PP05, 27, 5, '-');
-            display_putc(FONT_PP05, 23, 5, '-');
-            break;
-        }
+        display_puts_P(FONT_PP05, 31, 5, ALIGN_LEFT,
+            month_names[ct->mo <= 12 ? ct->mo : 0]);
     }
     // Draw days
     if (mask & (1 << 9)) {
@@ -669,43 +444,8 @@ void draw_config_set_time_mod(ctime_t* ct, dow_t dow, uint8_t icon_l,
     }
     // Draw day-of-week string
     if (mask & (1 << 8)) {
-        switch (dow) {
-        case DOW_SUNDAY:
-            display_putc(FONT_PP05, 31, 11, 'S');
-            display_putc(FONT_PP05, 27, 11, 'u');
-            display_putc(FONT_PP05, 23, 11, 'n');
-            break;
-        case DOW_MONDAY:
-            display_putc(FONT_PP05, 31, 11, 'M');
-            display_putc(FONT_PP05, 25, 11, 'o');
-            display_putc(FONT_PP05, 21, 11, 'n');
-            break;
-        case DOW_TUESDAY:
-            display_putc(FONT_PP05, 31, 11, 'T');
-            display_putc(FONT_PP05, 27, 11, 'u');
-            display_putc(FONT_PP05, 23, 11, 'e');
-            break;
-        case DOW_WEDNESDAY:
-            display_putc(FONT_PP05, 31, 11, 'W');
-            display_putc(FONT_PP05, 25, 11, 'e');
-            display_putc(FONT_PP05, 21, 11, 'd');
-            break;
-        case DOW_THURSDAY:
-            display_putc(FONT_PP05, 31, 11, 'T');
-            display_putc(FONT_PP05, 27, 11, 'h');
-            display_putc(FONT_PP05, 23, 11, 'u');
-            break;
-        case DOW_FRIDAY:
-            display_putc(FONT_PP05, 31, 11, 'F');
-            display_putc(FONT_PP05, 27, 11, 'r');
-            display_putc(FONT_PP05, 24, 11, 'i');
-            break;
-        case DOW_SATURDAY:
-            display_putc(FONT_PP05, 31, 11, 'S');
-            display_putc(FONT_PP05, 27, 11, 'a');
-            display_putc(FONT_PP05, 23, 11, 't');
-            break;
-        }
+        display_puts_P(FONT_PP05, 31, 11, ALIGN_LEFT,
+            dow_names[dow <= DOW_SATURDAY ? dow : 0]);
     }
     // Draw colon
     if (mask & (1 << 14)) {
@@ -749,16 +489,8 @@ void draw_config_relay_event_top(uint8_t i, uint8_t count, uint16_t mask) {
     }
     // Draw caption string "Setup Relay"
     if (mask & (1 << 2)) {
-        display_putc(FONT_PP05, 31, 5, 'S');
-        display_putc(FONT_PP05, 27, 5, 'e');
-        display_putc(FONT_PP05, 23, 5, 't');
-        display_putc(FONT_PP05, 20, 5, 'u');
-        display_putc(FONT_PP05, 16, 5, 'p');
-        display_putc(FONT_PP05, 31, 11, 'R');
-        display_putc(FONT_PP05, 27, 11, 'e');
-        display_putc(FONT_PP05, 24, 11, 'l');
-        display_putc(FONT_PP05, 21, 11, 'a');
-        display_putc(FONT_PP05, 17, 11, 'y');
+        display_puts_P(FONT_PP05, 31, 5, ALIGN_LEFT, PSTR("Setup"));
+        display_puts_P(FONT_PP05, 31, 11, ALIGN_LEFT, PSTR("Relay"));
     }
     // Draw relay number
     if (mask & (1 << 8)) {
@@ -887,43 +619,8 @@ void draw_config_relay_event_mask(uint8_t i, event_t* ev, uint8_t index_dow,
     }
     // Draw day-of-week string
     if (mask & (1 << 8)) {
-        switch (index_dow) {
-        case DOW_SUNDAY:
-            display_putc(FONT_PP05, 18, 5, 'S');
-            display_putc(FONT_PP05, 14, 5, 'u');
-            display_putc(FONT_PP05, 10, 5, 'n');
-            break;
-        case DOW_MONDAY:
-            display_putc(FONT_PP05, 18, 5, 'M');
-            display_putc(FONT_PP05, 12, 5, 'o');
-            display_putc(FONT_PP05, 8, 5, 'n');
-            break;
-        case DOW_TUESDAY:
-            display_putc(FONT_PP05, 18, 5, 'T');
-            display_putc(FONT_PP05, 14, 5, 'u');
-            display_putc(FONT_PP05, 10, 5, 'e');
-            break;
-        case DOW_WEDNESDAY:
-            display_putc(FONT_PP05, 18, 5, 'W');
-            display_putc(FONT_PP05, 12, 5, 'e');
-            display_putc(FONT_PP05, 8, 5, 'd');
-            break;
-        case DOW_THURSDAY:
-            display_putc(FONT_PP05, 18, 5, 'T');
-            display_putc(FONT_PP05, 14, 5, 'h');
-            display_putc(FONT_PP05, 10, 5, 'u');
-            break;
-        case DOW_FRIDAY:
-            display_putc(FONT_PP05, 18, 5, 'F');
-            display_putc(FONT_PP05, 14, 5, 'r');
-            display_putc(FONT_PP05, 11, 5, 'i');
-            break;
-        case DOW_SATURDAY:
-            display_putc(FONT_PP05, 18, 5, 'S');
-            display_putc(FONT_PP05, 14, 5, 'a');
-            display_putc(FONT_PP05, 10, 5, 't');
-            break;
-        }
+        display_puts_P(FONT_PP05, 18, 5, ALIGN_LEFT,
+            dow_names[index_dow <= DOW_SATURDAY ? index_dow : 0]);
     }
     // Draw ballot box
     if (mask & (1 << 6)) {
@@ -931,14 +628,8 @@ void draw_config_relay_event_mask(uint8_t i, event_t* ev, uint8_t index_dow,
     }
     // Draw value string "on"/"off"
     if (mask & (1 << 5)) {
-        if (enabled) {
-            display_putc(FONT_PP05, 8, 11, 'o');
-            display_putc(FONT_PP05, 4, 11, 'n');
-        } else {
-            display_putc(FONT_PP05, 9, 11, 'o');
-            display_putc(FONT_PP05, 5, 11, 'f');
-            display_putc(FONT_PP05, 2, 11, 'f');
-        }
+        display_puts_P(FONT_PP05, 5, 11, ALIGN_CENTER,
+            enabled ? PSTR("on") : PSTR("off"));
     }
     // Draw event mask indicator dots
     for (uint8_t i = 0; i < 7; i++) {
@@ -953,7 +644,7 @@ void draw_config_brightness(uint8_t br, uint16_t mask) {
     // Bit mask of drawable elements
     //   mask<15:7>  reserved
     //       <6>     bar image
-    //       <5>     value string "auto"/"1"/"2"/"3"/"4"
+    //       <5>     value string "auto"/"1".."15"
     //       <4:3>   reserved
     //       <2>     condensed caption string "Brightness"
     //       <1>     left button icon <changevalue>
@@ -976,63 +667,43 @@ void draw_config_brightness(uint8_t br, uint16_t mask) {
         display_putc(FONT_PP05, 15, 5, '\215');
         display_putc(FONT_PP05, 7, 5, '\216');
     }
-    // Draw bar image
+    // Draw bar image in quarters of the brightness range
     if (mask & (1 << 6)) {
-        switch (br) {
-        case 1:
-            img0 = '\221';
-            img1 = '\222';
-            break;
-        case 2:
-            img0 = '\223';
-            img1 = '\224';
-            break;
-        case 3:
-            img0 = '\223';
-            img1 = '\225';
-            break;
-        case 4:
-            img0 = '\223';
-            img1 = '\223';
-            break;
-        default:
+        if (br > BRIGHTNESS_MAX) {
             img0 = '\217';
             img1 = '\220';
-            break;
+        } else {
+            switch ((br + 3) >> 2) {
+            case 1:
+                img0 = '\221';
+                img1 = '\222';
+                break;
+            case 2:
+                img0 = '\223';
+                img1 = '\224';
+                break;
+            case 3:
+                img0 = '\223';
+                img1 = '\225';
+                break;
+            default:
+                img0 = '\223';
+                img1 = '\223';
+                break;
+            }
         }
         display_putc(FONT_PP05, 31, 11, img0);
         display_putc(FONT_PP05, 23, 11, img1);
     }
-    // Draw value string "auto"/"1"/"2"/"3"/"4"
+    // Draw value string "auto"/"1".."15"
     if (mask & (1 << 5)) {
-        switch (br) {
-        case 1:
-            display_putc(FONT_PP05, 11, 11, '2');
-            display_putc(FONT_PP05, 7, 11, '5');
-            display_putc(FONT_PP05, 3, 11, '%');
-            break;
-        case 2:
-            display_putc(FONT_PP05, 11, 11, '5');
-            display_putc(FONT_PP05, 7, 11, '0');
-            display_putc(FONT_PP05, 3, 11, '%');
-            break;
-        case 3:
-            display_putc(FONT_PP05, 11, 11, '7');
-            display_putc(FONT_PP05, 7, 11, '5');
-            display_putc(FONT_PP05, 3, 11, '%');
-            break;
-        case 4:
-            display_putc(FONT_PP05, 14, 11, '1');
-            display_putc(FONT_PP05, 11, 11, '0');
-            display_putc(FONT_PP05, 7, 11, '0');
-            display_putc(FONT_PP05, 3, 11, '%');
-            break;
-        default:
-            display_putc(FONT_PP05, 13, 11, 'a');
-            display_putc(FONT_PP05, 9, 11, 'u');
-            display_putc(FONT_PP05, 5, 11, 't');
-            display_putc(FONT_PP05, 2, 11, 'o');
-            break;
+        if (br > BRIGHTNESS_MAX) {
+            display_puts_P(FONT_PP05, 0, 11, ALIGN_RIGHT, PSTR("auto"));
+        } else if (br >= 10) {
+            display_putc(FONT_PP05, 6, 11, '1');
+            display_putc(FONT_PP05, 3, 11, '0' + br - 10);
+        } else {
+            display_putc(FONT_PP05, 3, 11, '0' + br);
         }
     }
 }
@@ -1057,14 +728,7 @@ void draw_config_save_confirm(bool save_to_ee, uint16_t mask) {
     }
     // Draw caption string "Save to EE"
     if (mask & (1 << 2)) {
-        display_putc(FONT_PP05, 31, 5, 'S');
-        display_putc(FONT_PP05, 27, 5, 'a');
-        display_putc(FONT_PP05, 23, 5, 'v');
-        display_putc(FONT_PP05, 19, 5, 'e');
-        display_putc(FONT_PP05, 14, 5, 't');
-        display_putc(FONT_PP05, 11, 5, 'o');
-        display_putc(FONT_PP05, 6, 5, 'E');
-        display_putc(FONT_PP05, 2, 5, 'E');
+        display_puts_P(FONT_PP05, 31, 5, ALIGN_LEFT, PSTR("Save to EE"));
     }
     // Draw ballot box
     if (mask & (1 << 6)) {
@@ -1072,33 +736,17 @@ void draw_config_save_confirm(bool save_to_ee, uint16_t mask) {
     }
     // Draw value string "yes"/"no"
     if (mask & (1 << 5)) {
-        if (save_to_ee) {
-            display_putc(FONT_PP05, 10, 11, 'y');
-            display_putc(FONT_PP05, 6, 11, 'e');
-            display_putc(FONT_PP05, 2, 11, 's');
-        } else {
-            display_putc(FONT_PP05, 9, 11, 'n');
-            display_putc(FONT_PP05, 5, 11, 'o');
-        }
+        display_puts_P(FONT_PP05, 5, 11, ALIGN_CENTER,
+            save_to_ee ? PSTR("yes") : PSTR("no"));
     }
 }
 
 // Draw ADC value of light sensor
 void draw_light_adc(uint16_t adc) {
     // Draw caption string "Light sen."
-    display_putc(FONT_PP05, 31, 0, 'L');
-    display_putc(FONT_PP05, 27, 0, 'i');
-    display_putc(FONT_PP05, 25, 0, 'g');
-    display_putc(FONT_PP05, 21, 0, 'h');
-    display_putc(FONT_PP05, 17, 0, 't');
-    display_putc(FONT_PP05, 13, 0, 's');
-    display_putc(FONT_PP05, 9, 0, 'e');
-    display_putc(FONT_PP05, 5, 0, 'n');
-    display_putc(FONT_PP05, 1, 0, '.');
+    display_puts_P(FONT_PP05, 31, 0, ALIGN_LEFT, PSTR("Light sen."));
     // Draw caption string "ADC"
-    display_putc(FONT_PP05, 31, 11, 'A');
-    display_putc(FONT_PP05, 27, 11, 'D');
-    display_putc(FONT_PP05, 23, 11, 'C');
+    display_puts_P(FONT_PP05, 31, 11, ALIGN_LEFT, PSTR("ADC"));
     // Draw ADC value
     if (adc >= 1000) {
         display_putc(FONT_M0410, 18, 6, '0' + adc / 1000 % 10);
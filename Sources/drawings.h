@@ -18,13 +18,17 @@ typedef struct {
     uint8_t frame;
 } cdigit_t;
 
-void draw_time_hm(ctime_t* ct, uint16_t mask);
-void draw_time_hms(ctime_t* ct, uint16_t mask);
+void update_cdigit(ctime_t* ct);
+void update_cdigit_with_scroll(ctime_t* ct);
+void draw_time_hm(uint16_t mask);
+void draw_time_hms(uint16_t mask);
 void draw_date_dayofweek(ctime_t* ct, dow_t dow, uint16_t mask);
 void draw_date_year(ctime_t* ct, uint16_t mask);
 void draw_temperature(bool result, uint8_t sign, uint8_t integer,
     uint16_t fraction_x10k, uint16_t mask);
-void draw_gps_status(uint8_t fix, uint8_t blink_phase, uint16_t mask);
+void draw_gps_status(uint8_t fix, uint8_t blink_phase, marquee_t* mq,
+    uint16_t mask);
+void draw_message(marquee_t* mq, uint16_t mask);
 void draw_config_use_gps(bool use_gps, uint16_t mask);
 void draw_config_set_time_top(uint16_t mask);
 void draw_config_set_time_mod(ctime_t* ct, dow_t dow, uint8_t icon_l,
@@ -60,3 +60,35 @@ void eeprom_redun_write(eeredun_t* eer, uint8_t* blob) {
     eeprom_update(eer->base.timestamp + wp,
         eeprom_read(eer->base.timestamp + p) + 1);
 }
+
+// Start writing entity to EEPROM block with redundancy in steps;
+// ... the block read stays the same until the last step
+void eeprom_redun_write_begin(eeredun_t* eer, eeredun_progress_t* pr) {
+    uint8_t p = eeprom_redun_pointer(eer);
+    
+    pr->wp = p >= eer->redundancy - 1 ? 0 : p + 1;
+    pr->i = 0;
+}
+
+// Write entity in steps of at most a byte programmed, skipping bytes
+// ... already written, and the timestamp at last
+// ... return true when finished
+bool eeprom_redun_write_step(eeredun_t* eer, eeredun_progress_t* pr,
+    uint8_t* blob) {
+    uint16_t base_w = eer->base.entity + eer->stride * pr->wp;
+    uint8_t p = pr->wp == 0 ? eer->redundancy - 1 : pr->wp - 1;
+    
+    // Write entity blob
+    while (pr->i < eer->stride) {
+        if (eeprom_read(base_w + pr->i) != blob[pr->i]) {
+            eeprom_update(base_w + pr->i, blob[pr->i]);
+            pr->i++;
+            return false;
+        }
+        pr->i++;
+    }
+    // Write timestamp
+    eeprom_update(eer->base.timestamp + pr->wp,
+        eeprom_read(eer->base.timestamp + p) + 1);
+    return true;
+}
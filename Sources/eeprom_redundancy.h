@@ -25,9 +25,20 @@ typedef struct {
     } base;
 } eeredun_t;
 
+// Progress of writing an entity a byte at a time
+typedef struct {
+    // Block being written
+    uint8_t wp;
+    // Index of the entity byte to write next
+    uint16_t i;
+} eeredun_progress_t;
+
 void eeprom_redun_initialize(eeredun_t* eer);
 uint8_t eeprom_redun_pointer(eeredun_t* eer);
 void eeprom_redun_read(eeredun_t* eer, uint8_t* blob);
 void eeprom_redun_write(eeredun_t* eer, uint8_t* blob);
+void eeprom_redun_write_begin(eeredun_t* eer, eeredun_progress_t* pr);
+bool eeprom_redun_write_step(eeredun_t* eer, eeredun_progress_t* pr,
+    uint8_t* blob);
 
 #endif
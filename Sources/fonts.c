@@ -0,0 +1,370 @@
+/*
+ * DotMatrixClock2018/fonts.c
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ *
+ *  Generated by Tools/fontc.py from Tools/fonts/; do not edit by hand.
+ */
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "fonts.h"
+
+// Code ranges for font "M0410"
+PROGMEM uint8_t const font_ranges_m0410[9] = {
+    // first, last, first glyph
+    0x20, 0x20,   1,
+    0x2d, 0x2e,   2,
+    0x30, 0x3a,   4
+};
+// Bitmap for font "M0410"
+// (2 lines per byte, upper nibble first)
+PROGMEM uint8_t const font_bitmap_m0410[] = {
+    // (  0) unimplemented character
+    0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+    // (  1) space
+    0x00, 0x00, 0x00, 0x00, 0x00,
+    // (  2) -
+    0x00, 0x00, 0x07, 0x70, 0x00,
+    // (  3) .
+    0x00, 0x00, 0x00, 0x00, 0xcc,
+    // (  4) 0
+    0x6f, 0xbb, 0xbb, 0xbb, 0xf6,
+    // (  5) 1
+    0xee, 0x66, 0x66, 0x66, 0xff,
+    // (  6) 2
+    0xef, 0x33, 0x36, 0xc8, 0xff,
+    // (  7) 3
+    0xff, 0x36, 0x73, 0x33, 0xfe,
+    // (  8) 4
+    0x3b, 0xbb, 0xbb, 0xff, 0x33,
+    // (  9) 5
+    0xff, 0x8e, 0xf3, 0x33, 0xfe,
+    // ( 10) 6
+    0x7f, 0x8e, 0xfb, 0xbb, 0xf6,
+    // ( 11) 7
+    0xff, 0x33, 0x66, 0x6c, 0xcc,
+    // ( 12) 8
+    0x6f, 0xdd, 0xe7, 0xbb, 0xf6,
+    // ( 13) 9
+    0x6f, 0xbb, 0xbf, 0x73, 0xfe,
+    // ( 14) :
+    0x00, 0x0c, 0xc0, 0x0c, 0xc0
+};
+
+// Code ranges for font "M0610"
+PROGMEM uint8_t const font_ranges_m0610[15] = {
+    // first, last, first glyph
+    0x03, 0x03,   1,
+    0x06, 0x06,   2,
+    0x20, 0x20,   3,
+    0x25, 0x25,   4,
+    0x30, 0x39,   5
+};
+// Bitmap for font "M0610"
+PROGMEM uint8_t const font_bitmap_m0610[] = {
+    // (  0) unimplemented character
+    0x2a, 0x15, 0x2a, 0x15, 0x2a, 0x15, 0x2a, 0x15, 0x2a, 0x15,
+    // (  1) degree celsius
+    0x00, 0x38, 0x2f, 0x3f, 0x18, 0x18, 0x18, 0x18, 0x1f, 0x0f,
+    // (  2) degree fahrenheit
+    0x00, 0x38, 0x2f, 0x3f, 0x18, 0x1e, 0x1e, 0x18, 0x18, 0x18,
+    // (  3) space
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // (  4) %
+    0x00, 0x00, 0x38, 0x2b, 0x37, 0x0e, 0x1c, 0x3b, 0x35, 0x37,
+    // (  5) 0
+    0x1e, 0x3f, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3f, 0x1e,
+    // (  6) 1
+    0x1c, 0x1c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x1e, 0x1e,
+    // (  7) 2
+    0x3e, 0x3f, 0x03, 0x03, 0x07, 0x0e, 0x1c, 0x38, 0x3f, 0x3f,
+    // (  8) 3
+    0x3f, 0x3f, 0x03, 0x07, 0x0e, 0x0f, 0x03, 0x03, 0x3f, 0x3e,
+    // (  9) 4
+    0x03, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3f, 0x3f, 0x03, 0x03,
+    // ( 10) 5
+    0x3f, 0x3f, 0x30, 0x3e, 0x3f, 0x03, 0x03, 0x03, 0x3f, 0x3e,
+    // ( 11) 6
+    0x1e, 0x3e, 0x30, 0x3e, 0x3f, 0x33, 0x33, 0x33, 0x3f, 0x1e,
+    // ( 12) 7
+    0x3f, 0x3f, 0x03, 0x03, 0x06, 0x06, 0x0c, 0x0c, 0x18, 0x18,
+    // ( 13) 8
+    0x1e, 0x3f, 0x33, 0x33, 0x1e, 0x3f, 0x33, 0x33, 0x3f, 0x1e,
+    // ( 14) 9
+    0x1e, 0x3f, 0x33, 0x33, 0x33, 0x3f, 0x1f, 0x03, 0x1f, 0x1e
+};
+
+// Code ranges for font "PP05"
+PROGMEM uint8_t const font_ranges_pp05[15] = {
+    // first, last, first glyph
+    0x20, 0x7f,   1,
+    0x80, 0x85, 110,
+    0x86, 0x8a,  97,
+    0x8b, 0x95, 116,
+    0x9a, 0xa1, 102
+};
+// Bitmap for font "PP05"
+// (glyphs of width 5 or less in 4 bytes; lines 0..3 in lower 5 bits,
+// line 4 in upper 3 bits of bytes 0..1 and width in those of byte 2)
+PROGMEM uint8_t const font_bitmap_pp05[] = {
+    // (  0) unimplemented character
+    0xa5, 0x02, 0x65, 0x02,
+    // (  1) space
+    0x00, 0x00, 0x00, 0x00,
+    // (  2) !
+    0x21, 0x01, 0x21, 0x00,
+    // (  3) "
+    0x05, 0x05, 0x60, 0x00,
+    // (  4) #
+    0xa5, 0x0f, 0x85, 0x0f,
+    // (  5) $
+    0xe7, 0x06, 0x67, 0x03,
+    // (  6) %
+    0x60, 0x2d, 0x8a, 0x05,
+    // (  7) &
+    0xee, 0x28, 0x87, 0x0a,
+    // (  8) '
+    0x01, 0x01, 0x20, 0x00,
+    // (  9) (
+    0x21, 0x02, 0x42, 0x02,
+    // ( 10) )
+    0x42, 0x01, 0x41, 0x01,
+    // ( 11) *
+    0x00, 0x05, 0x62, 0x05,
+    // ( 12) +
+    0x00, 0x02, 0x67, 0x02,
+    // ( 13) ,
+    0x40, 0x00, 0x40, 0x01,
+    // ( 14) -
+    0x00, 0x00, 0x67, 0x00,
+    // ( 15) .
+    0x20, 0x00, 0x20, 0x00,
+    // ( 16) /
+    0x40, 0x01, 0x41, 0x02,
+    // ( 17) 0
+    0xe7, 0x05, 0x65, 0x05,
+    // ( 18) 1
+    0xe6, 0x02, 0x62, 0x02,
+    // ( 19) 2
+    0xe7, 0x01, 0x67, 0x04,
+    // ( 20) 3
+    0xe7, 0x01, 0x66, 0x01,
+    // ( 21) 4
+    0x21, 0x05, 0x65, 0x07,
+    // ( 22) 5
+    0xe7, 0x04, 0x67, 0x01,
+    // ( 23) 6
+    0xe7, 0x04, 0x67, 0x05,
+    // ( 24) 7
+    0x47, 0x01, 0x61, 0x02,
+    // ( 25) 8
+    0xe7, 0x05, 0x67, 0x05,
+    // ( 26) 9
+    0xe7, 0x05, 0x67, 0x01,
+    // ( 27) :
+    0x20, 0x01, 0x20, 0x00,
+    // ( 28) ;
+    0x40, 0x01, 0x40, 0x01,
+    // ( 29) <
+    0x21, 0x02, 0x64, 0x02,
+    // ( 30) =
+    0x00, 0x07, 0x60, 0x07,
+    // ( 31) >
+    0x84, 0x02, 0x61, 0x02,
+    // ( 32) ?
+    0x47, 0x01, 0x63, 0x00,
+    // ( 33) @
+    0xe7, 0x09, 0x8b, 0x08,
+    // ( 34) A
+    0xa7, 0x05, 0x65, 0x07,
+    // ( 35) B
+    0xe7, 0x05, 0x66, 0x05,
+    // ( 36) C
+    0xe7, 0x04, 0x64, 0x04,
+    // ( 37) D
+    0xc6, 0x05, 0x65, 0x05,
+    // ( 38) E
+    0xe7, 0x04, 0x67, 0x04,
+    // ( 39) F
+    0x87, 0x04, 0x67, 0x04,
+    // ( 40) G
+    0xe7, 0x04, 0x65, 0x05,
+    // ( 41) H
+    0xa5, 0x05, 0x67, 0x05,
+    // ( 42) I
+    0xe7, 0x02, 0x62, 0x02,
+    // ( 43) J
+    0xc3, 0x01, 0x61, 0x01,
+    // ( 44) K
+    0xa5, 0x05, 0x66, 0x05,
+    // ( 45) L
+    0xe4, 0x04, 0x64, 0x04,
+    // ( 46) M
+    0x31, 0x5b, 0xb5, 0x11,
+    // ( 47) N
+    0x29, 0x2d, 0x8b, 0x09,
+    // ( 48) O
+    0xe7, 0x05, 0x65, 0x05,
+    // ( 49) P
+    0x87, 0x05, 0x65, 0x07,
+    // ( 50) Q
+    0x67, 0x05, 0x65, 0x06,
+    // ( 51) R
+    0xa7, 0x05, 0x65, 0x06,
+    // ( 52) S
+    0xe7, 0x04, 0x62, 0x01,
+    // ( 53) T
+    0x47, 0x02, 0x62, 0x02,
+    // ( 54) U
+    0xe5, 0x05, 0x65, 0x05,
+    // ( 55) V
+    0xc5, 0x05, 0x65, 0x05,
+    // ( 56) W
+    0xd1, 0x75, 0xb5, 0x15,
+    // ( 57) X
+    0xa5, 0x05, 0x62, 0x05,
+    // ( 58) Y
+    0x45, 0x05, 0x67, 0x02,
+    // ( 59) Z
+    0xe7, 0x01, 0x62, 0x04,
+    // ( 60) [
+    0x63, 0x02, 0x42, 0x02,
+    // ( 61) backslash
+    0x20, 0x02, 0x42, 0x01,
+    // ( 62) ]
+    0x63, 0x01, 0x41, 0x01,
+    // ( 63) ^
+    0x02, 0x05, 0x60, 0x00,
+    // ( 64) _
+    0xe0, 0x00, 0x60, 0x00,
+    // ( 65) `
+    0x02, 0x01, 0x60, 0x00,
+    // ( 66) a
+    0xe0, 0x06, 0x63, 0x05,
+    // ( 67) b
+    0xe4, 0x07, 0x65, 0x05,
+    // ( 68) c
+    0xe0, 0x07, 0x64, 0x04,
+    // ( 69) d
+    0xe1, 0x07, 0x65, 0x05,
+    // ( 70) e
+    0x60, 0x03, 0x65, 0x06,
+    // ( 71) f
+    0x43, 0x02, 0x43, 0x02,
+    // ( 72) g
+    0xc0, 0x03, 0x65, 0x03,
+    // ( 73) h
+    0xa4, 0x07, 0x65, 0x05,
+    // ( 74) i
+    0x21, 0x00, 0x21, 0x01,
+    // ( 75) j
+    0x41, 0x00, 0x41, 0x01,
+    // ( 76) k
+    0xa4, 0x05, 0x66, 0x05,
+    // ( 77) l
+    0x23, 0x01, 0x41, 0x01,
+    // ( 78) m
+    0xa0, 0x5e, 0xb5, 0x15,
+    // ( 79) n
+    0xa0, 0x06, 0x65, 0x05,
+    // ( 80) o
+    0xe0, 0x07, 0x65, 0x05,
+    // ( 81) p
+    0x80, 0x07, 0x65, 0x07,
+    // ( 82) q
+    0x20, 0x07, 0x65, 0x07,
+    // ( 83) r
+    0x40, 0x03, 0x42, 0x02,
+    // ( 84) s
+    0xe0, 0x03, 0x66, 0x01,
+    // ( 85) t
+    0x62, 0x03, 0x42, 0x02,
+    // ( 86) u
+    0xe0, 0x05, 0x65, 0x05,
+    // ( 87) v
+    0xc0, 0x05, 0x65, 0x05,
+    // ( 88) w
+    0xc0, 0x75, 0xb5, 0x15,
+    // ( 89) x
+    0xa0, 0x05, 0x62, 0x05,
+    // ( 90) y
+    0xc0, 0x05, 0x65, 0x03,
+    // ( 91) z
+    0xe0, 0x07, 0x62, 0x04,
+    // ( 92) {
+    0x63, 0x02, 0x66, 0x02,
+    // ( 93) |
+    0x21, 0x01, 0x21, 0x01,
+    // ( 94) }
+    0xc6, 0x02, 0x63, 0x02,
+    // ( 95) ~
+    0x07, 0x00, 0x60, 0x00,
+    // ( 96) \177 degree
+    0x07, 0x05, 0x67, 0x00,
+    // ( 97) \206 ballot box
+    0xff, 0x71, 0xb1, 0x11,
+    // ( 98) \207 ballot box with check
+    0xff, 0x73, 0xb5, 0x19,
+    // ( 99) \210 lower single dot
+    0x00, 0x00, 0x20, 0x01,
+    // (100) \211 higher single dot
+    0x00, 0x01, 0x20, 0x00,
+    // (101) \212 wavedash
+    0x00, 0x00, 0x8d, 0x0b,
+    // (102) \232 Dot blinker <1>
+    0x00, 0x03, 0x67, 0x07,
+    // (103) \233 Dot blinker <2>
+    0x00, 0x05, 0x67, 0x07,
+    // (104) \234 Dot blinker <3>
+    0x00, 0x06, 0x67, 0x07,
+    // (105) \235 Dot blinker <4>
+    0x00, 0x07, 0x66, 0x07,
+    // (106) \236 Dot blinker <5>
+    0x00, 0x07, 0x67, 0x06,
+    // (107) \237 Dot blinker <6>
+    0x00, 0x07, 0x67, 0x05,
+    // (108) \240 Dot blinker <7>
+    0x00, 0x07, 0x67, 0x03,
+    // (109) \241 Dot blinker <8>
+    0x00, 0x07, 0x63, 0x07
+};
+// Bitmap of wider glyphs for font "PP05"
+// (each character has 1 width byte on its head)
+PROGMEM uint8_t const font_wide_pp05[] = {
+    // (110) \200 button icon <up>
+    8, 0x08, 0x1c, 0x3e, 0x00, 0x00,
+    // (111) \201 button icon <down>
+    8, 0x00, 0x3e, 0x1c, 0x08, 0x00,
+    // (112) \202 button icon <next>
+    8, 0x24, 0x36, 0x36, 0x24, 0x00,
+    // (113) \203 button icon <changevalue>
+    8, 0x00, 0x04, 0x6e, 0x04, 0x00,
+    // (114) \204 button icon <discard>
+    8, 0x24, 0x18, 0x18, 0x24, 0x00,
+    // (115) \205 button icon <save>
+    8, 0x04, 0x2c, 0x38, 0x10, 0x00,
+    // (116) \213 condensed string block "Brightness" (first quarter)
+    8, 0xe2, 0xac, 0xca, 0xaa, 0xea,
+    // (117) \214 condensed string block "Brightness" (second quarter)
+    8, 0x08, 0x6e, 0xaa, 0x6a, 0xca,
+    // (118) \215 condensed string block "Brightness" (third quarter)
+    8, 0x80, 0xd8, 0x95, 0x95, 0xd4,
+    // (119) \216 condensed string block "Brightness" (fourth quarter)
+    8, 0x00, 0xdb, 0x52, 0x89, 0xdb,
+    // (120) \217 brightness bar image <auto> (first half)
+    8, 0x00, 0xff, 0xd5, 0xaa, 0xff,
+    // (121) \220 brightness bar image <auto> (last half)
+    8, 0x00, 0xff, 0x55, 0xab, 0xff,
+    // (122) \221 brightness bar image <1> (first half)
+    8, 0x00, 0xff, 0xf0, 0xf8, 0xff,
+    // (123) \222 brightness bar image <1> (last half)
+    8, 0x00, 0xff, 0x01, 0x01, 0xff,
+    // (124) \223 brightness bar image <2..4> (first half) or <4> (last half)
+    8, 0x00, 0xff, 0xff, 0xff, 0xff,
+    // (125) \224 brightness bar image <2> (last half)
+    8, 0x00, 0xff, 0x01, 0x81, 0xff,
+    // (126) \225 brightness bar image <3> (last half)
+    8, 0x00, 0xff, 0xf1, 0xf9, 0xff
+};
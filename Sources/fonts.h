@@ -0,0 +1,34 @@
+/*
+ * DotMatrixClock2018/fonts.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ *
+ *  Generated by Tools/fontc.py from Tools/fonts/; do not edit by hand.
+ */
+
+#ifndef FONTS_H_
+#define FONTS_H_
+
+// Font "M0410"
+#define FONT_M0410_RANGES  3
+#define FONT_M0410_STRIDE  5
+extern uint8_t const font_ranges_m0410[];
+extern uint8_t const font_bitmap_m0410[];
+
+// Font "M0610"
+#define FONT_M0610_RANGES  5
+#define FONT_M0610_STRIDE  10
+extern uint8_t const font_ranges_m0610[];
+extern uint8_t const font_bitmap_m0610[];
+
+// Font "PP05"
+#define FONT_PP05_RANGES  5
+#define FONT_PP05_STRIDE  4
+#define FONT_PP05_NARROW  110
+#define FONT_PP05_WIDE_STRIDE  6
+extern uint8_t const font_ranges_pp05[];
+extern uint8_t const font_bitmap_pp05[];
+extern uint8_t const font_wide_pp05[];
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * DotMatrixClock2018/hal.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#ifndef HAL_H_
+#define HAL_H_
+
+// System clock frequency in Hz
+#define F_CPU  20000000ul
+
+// With SINGLE_TIMER_ISR defined, the display ISR of Timer0 calls the
+// ... system tick every millisecond on average, instead of its own ISR of
+// ... Timer1, which is left stopped for other uses. The profiler and the
+// ... event trace time with Timer1, so they are not available then
+#if defined(SINGLE_TIMER_ISR) && (defined(PROFILER) || defined(TRACE))
+#error "PROFILER and TRACE need Timer1, which SINGLE_TIMER_ISR frees"
+#endif
+
+// Hardware abstraction layer;
+// ... I/O accesses outside of peripheral drivers (adc, eeprom, twi) go
+// ... through here. On target they expand to bare SFR accesses in place,
+// ... on native builds (Tools/sim) they are provided by peripheral models
+
+#ifdef __AVR__
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+// Get input levels of keys; bit 0: key 0 (PC0), bit 1: key 1 (PC1)
+#define hal_read_keys()  (PINC & ((1 << PINC1) | (1 << PINC0)))
+// Set relay outputs; bit 0..2: relay 1..3 (PB0..PB2)
+#define hal_write_relays(port) \
+    (PORTB = (PORTB & 0xf8) | ((port) << PORTB0))
+// Get receiver errors of the byte received over USART, to be read before
+// ... the byte itself
+#define HAL_USART_DATA_OVERRUN  (1 << DOR0)
+#define HAL_USART_FRAME_ERROR   (1 << FE0)
+#define hal_usart_rx_errors() \
+    (UCSR0A & (HAL_USART_DATA_OVERRUN | HAL_USART_FRAME_ERROR))
+// Set the baud rate of USART in double speed mode, rounded to the nearest;
+// ... errors at 20 MHz are within +/-0.2% up to 38400 baud, +0.9% at
+// ... 57600 and -1.4% at 115200
+#define hal_usart_set_baud(baud) \
+    (UBRR0 = (F_CPU / 4 / (baud) + 1) / 2 - 1)
+// Get a byte received over USART
+#define hal_usart_receive()  (UDR0)
+// Set a byte to transmit over USART; transmitter must be ready
+#define hal_usart_transmit(d)  (UDR0 = (d))
+// Enable/disable USART Data Register Empty interrupt
+#define hal_usart_start_tx()  (UCSR0B |= (1 << UDRIE0))
+#define hal_usart_stop_tx()  (UCSR0B &= ~(1 << UDRIE0))
+// Get the count of Timer1 in the current tick (0..F_CPU / 1000 - 1)
+#define hal_timer1_count()  (TCNT1)
+// Enable/disable all interrupts
+#define hal_enable_interrupts()  sei()
+#define hal_disable_interrupts()  cli()
+// Wait for interrupts in the main loop and busy loops; to be called with
+// ... interrupts disabled after checking what to wait for, and returns
+// ... with them enabled. The instruction after SEI runs before any
+// ... interrupt, so one pending since the check wakes up the sleep.
+// ... Sleep in Idle mode, where timers, USART and TWI keep running
+#define hal_idle() \
+    do { sleep_enable(); sei(); sleep_cpu(); sleep_disable(); } while (0)
+
+#else
+
+// Interrupt service routines are plain functions called by the models
+#define ISR(vector)  void vector(void)
+
+uint8_t hal_read_keys();
+void hal_write_relays(uint8_t port);
+#define HAL_USART_DATA_OVERRUN  0x08
+#define HAL_USART_FRAME_ERROR   0x10
+uint8_t hal_usart_rx_errors();
+void hal_usart_set_baud(uint32_t baud);
+uint8_t hal_usart_receive();
+void hal_usart_transmit(uint8_t d);
+void hal_usart_start_tx();
+void hal_usart_stop_tx();
+uint16_t hal_timer1_count();
+void hal_enable_interrupts();
+void hal_disable_interrupts();
+void hal_idle();
+
+#ifndef SINGLE_TIMER_ISR
+void TIMER1_COMPA_vect(void);
+#endif
+void USART_RX_vect(void);
+void USART_UDRE_vect(void);
+void TWI_vect(void);
+
+#endif
+
+#ifdef SINGLE_TIMER_ISR
+void tick_isr();
+#endif
+
+void setup_eeprom();
+void setup_power();
+void setup_io();
+void setup_timer0();
+void setup_timer1();
+void setup_usart0();
+void setup_twi();
+void setup_adc();
+
+#endif
@@ -0,0 +1,357 @@
+/*
+ * DotMatrixClock2018/hal_avr.c
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hal.h"
+#include "bench.h"
+#include "sched.h"
+#include "profile.h"
+#include "trace.h"
+#include "display.h"
+
+// Half counts of Timer0 (clkI/O / 64) per tick
+#define TICK_HALF_COUNTS  (F_CPU / 64 * 2 / 1000)
+
+// Front scan line plane and its swap request
+extern volatile scanline_t scan_planes[2][16];
+extern volatile scanline_t* volatile scan_front;
+extern volatile bool scan_swap_pending;
+
+// Display brightness
+extern volatile uint8_t display_brightness;
+
+// Setup EEPROM
+void setup_eeprom() {
+    EECR = (0 << EERIE) | (0 << EEMPE) | (0 << EEPE) | (0 << EERE);
+    //     0b--XX0XXX  (-: reserved bits)
+    //         |||||+-- EERE      EEPROM Read Enable
+    //         ||||+--- EEPE      EEPROM Write Enable
+    //         |||+---- EEMPE     EEPROM Master Write Enable 
+    //         ||+----- EERIE     EEPROM Ready Interrupt Enable: no
+    //         ++------ EEPM<1:0> EEPROM Programming Mode
+}
+
+// Setup sleep mode and power reduction
+void setup_power() {
+    SMCR = (0 << SM2) | (0 << SM1) | (0 << SM0) | (0 << SE);
+    //     0b----0000  (-: reserved bits)
+    //           |||+-- SE       Sleep Enable: no, set on each sleep
+    //           +++--- SM<2:0>  Sleep Mode Select: Idle
+    PRR = (0 << PRTWI) | (1 << PRTIM2) | (0 << PRTIM0) | (0 << PRTIM1) |
+        (1 << PRSPI) | (0 << PRUSART0) | (0 << PRADC);
+    //     0b010-0100  (-: reserved bits)
+    //       ||| |||+-- PRADC     Power Reduction ADC: no
+    //       ||| ||+--- PRUSART0  Power Reduction USART0: no
+    //       ||| |+---- PRSPI     Power Reduction SPI: yes
+    //       ||| +----- PRTIM1    Power Reduction Timer/Counter1: no
+    //       ||+------- PRTIM0    Power Reduction Timer/Counter0: no
+    //       |+-------- PRTIM2    Power Reduction Timer/Counter2: yes
+    //       +--------- PRTWI     Power Reduction TWI: no
+    ACSR = (1 << ACD) | (0 << ACBG) | (0 << ACIE);
+    //     0b10RX0XXX  (R: read-only bits)
+    //       ||  +----- ACIE  Analog Comparator Interrupt Enable: no
+    //       |+-------- ACBG  Analog Comparator Bandgap Select: no
+    //       +--------- ACD   Analog Comparator Disable: yes
+}
+
+// Setup I/O ports
+void setup_io() {
+    // == PORTB ==
+    // PB7/XTAL2: crystal oscillator
+    // PB6/XTAL1: crystal oscillator
+    // PB5/SCK:   not in use, only for programming
+    // PB4/MISO:  not in use, only for programming
+    // PB3/MOSI:  not in use, only for programming
+    // PB2:       Relay 2, normal-low output
+    // PB1:       Relay 1, normal-low output
+    // PB0:       Relay 0, normal-low output
+    // == PORTC ==
+    // PC6/RESET#: reset
+    // PC5/SCL:    TWI serial bus clock
+    // PC4/SDA:    TWI serial bus data
+    // PC3:        not in use
+    // PC2/ADC2:   Light sensor (photoresistor), analog input
+    // PC1:        Push key 1, pulled-up input
+    // PC0:        Push key 0, pulled-up input
+    // == PORTD ==
+    // PD7:     LED matrix module OE, output (low-active)
+    // PD6:     LED matrix module LAT, output
+    // PD5:     LED matrix module CLK, output
+    // PD4:     LED matrix module SIN3, output
+    // PD3:     LED matrix module SIN2, output
+    // PD2:     LED matrix module SIN1, output
+    // PD1/TXD: USART transmitter, output
+    // PD0/RXD: USART receiver, input
+    PORTB = (0 << PORTB7) | (0 << PORTB6) | (0 << PORTB5) | (0 << PORTB4) |
+        (0 << PORTB3) | (0 << PORTB2) | (0 << PORTB1) | (0 << PORTB0);
+    //     0b00000000
+    //       ++++++++-- PORTB<7:0> Port B Data
+    DDRB = (0 << DDB7) | (0 << DDB6) | (0 << DDB5) | (0 << DDB4) |
+        (0 << DDB3) | (1 << DDB2) | (1 << DDB1) | (1 << DDB0);
+    //     0b00000111
+    //       ++++++++-- DDRB<7:0> Port B Data Direction
+    PORTC = (0 << PORTC6) | (0 << PORTC5) | (0 << PORTC4) |
+        (0 << PORTC3) | (0 << PORTC2) | (1 << PORTC1) | (1 << PORTC0);
+    //     0b-0000011  (-: reserved bits)
+    //        +++++++-- PORTC<6:0> Port C Data
+    DDRC = (0 << DDC6) | (0 << DDC5) | (0 << DDC4) |
+        (0 << DDC3) | (0 << DDC2) | (0 << DDC1) | (0 << DDC0);
+    //     0b-0000000  (-: reserved bits)
+    //        +++++++-- DDRC<6:0> Port C Data Direction
+    PORTD = (0 << PORTD7) | (0 << PORTD6) | (0 << PORTD5) | (0 << PORTD4) |
+        (0 << PORTD3) | (0 << PORTD2) | (0 << PORTD1) | (0 << PORTD0);
+    //     0b00000000
+    //       ++++++++-- PORTD<7:0> Port D Data
+    DDRD = (1 << DDD7) | (1 << DDD6) | (1 << DDD5) | (1 << DDD4) |
+        (1 << DDD3) | (1 << DDD2) | (1 << DDD1) | (0 << DDD0);
+    //     0b11111110
+    //       ++++++++-- DDRD<7:0> Port D Data Direction
+}
+
+// Setup Timer/Counter 0
+void setup_timer0() {
+    TCCR0A = (0 << COM0A1) | (0 << COM0A0) | (0 << COM0B1) | (0 << COM0B0) |
+        (1 << WGM01) | (0 << WGM00);
+    //     0b0000--10  (-: reserved bits)
+    //       ||||  ++-- WGM0<1:0>  Waveform Generation: CTC, TOP=OCR0A
+    //       ||++------ COM0B<1:0> Compare Output Mode B: Normal
+    //       ++-------- COM0A<1:0> Compare Output Mode A: Normal
+    TCCR0B = (0 << FOC0A) | (0 << FOC0B) | (0 << WGM02) |
+        (0 << CS02) | (1 << CS01) | (1 << CS00);
+    //     0b00--0011  (-: reserved bits)
+    //       ||  |+++-- CS0<2:0> Clock Select: clkI/O / 64
+    //       ||  +----- WGM02    Waveform Generation  *see TCCR0A
+    //       |+-------- FOC0B    Force Output Compare B  *unused
+    //       +--------- FOC0A    Force Output Compare A  *unused
+        TIMSK0 = (0 << OCIE0B) | (1 << OCIE0A) | (0 << TOIE0);
+    //     0b-----010  (-: reserved bits)
+    //            ||+-- TOIE0   Overflow Interrupt Enable: no
+    //            |+--- OCIE0A  Compare A Match Int. Enable: yes
+    //            +---- OCIE0B  Compare B Match Int. Enable: no
+
+    // Period for the lightest bit-plane; reprogrammed by the display ISR
+    // ... on every bit-plane, see BCM_UNIT_COUNTS
+    OCR0A = BCM_UNIT_COUNTS - 1;
+    OCR0B = 0;
+
+    // Clear counter
+    TCNT0 = 0;
+}
+
+// Setup Timer/Counter 1
+void setup_timer1() {
+#ifdef SINGLE_TIMER_ISR
+    // Left stopped; ticks are counted by the display ISR
+    TCCR1B = 0;
+    TIMSK1 = 0;
+#else
+    TCCR1A = (0 << COM1A1) | (0 << COM1A0) | (0 << COM1B1) | (0 << COM1B0) |
+        (0 << WGM11) | (0 << WGM10);
+    //     0b0000--00  (-: reserved bits)
+    //       ||||  ++-- WGM1<1:0>  Waveform Generation: CTC, TOP=OCR1A
+    //       ||++------ COM1B<1:0> Compare Output Mode B: Normal
+    //       ++-------- COM1A<1:0> Compare Output Mode A: Normal
+    TCCR1B = (0 << ICNC1) | (0 << ICES1) | (0 << WGM13) | (1 << WGM12) |
+        (0 << CS12) | (0 << CS11) | (1 << CS10);
+    //     0b00-01001  (-: reserved bits)
+    //       || ||+++-- CS1<2:0>  Clock Select: clkI/O / 1
+    //       || ++----- WGM1<3:2> Waveform Generation  *see TCCR1A
+    //       |+-------- ICES1     Input Capture Edge Select  *unused
+    //       +--------- ICNC1     Input Capture Noise Canceler  *unused
+    TCCR1C = (0 << FOC1A) | (0 << FOC1B);
+    //     0b00------  (-: reserved bits)
+    //       |+-------- FOC1B  Force Output Compare B  *unused
+    //       +--------- FOC1A  Force Output Compare A  *unused
+    TIMSK1 = (0 << ICIE1) | (0 << OCIE1B) | (1 << OCIE1A) | (0 << TOIE1);
+    //     0b--0--010  (-: reserved bits)
+    //         |  ||+-- TOIE1   Overflow Interrupt Enable: No
+    //         |  |+--- OCIE1A  Compare A Match Interrupt Enable: yes
+    //         |  +---- OCIE1B  Compare B Match Interrupt Enable: no
+    //         +------- ICIE1   Input Capture Interrupt Enable: no
+
+    // 20e+6[Hz(CPU)] / 1000[Hz(int)] / 1[prescaler]
+    // ... actual value is 20000, error rate 0.00%
+    OCR1A = F_CPU / 1000 / 1 - 1;
+    OCR1B = 0;
+
+    // Clear counter
+    TCNT1 = 0;
+#endif
+}
+
+// Setup USART 0
+void setup_usart0() {
+    UCSR0A = (0 << TXC0) | (1 << U2X0) | (0 << MPCM0);
+    //     0bR0RRRR10  (R: read-only bits)
+    //       |||||||+-- MPCM0  Multi-processor Communication Mode  *unused
+    //       ||||||+--- U2X0   Double the USART Transmission Speed: yes
+    //       |||||+---- UPE0   USART Parity Error
+    //       ||||+----- DOR0   Data Overrun
+    //       |||+------ FE0    Frame Error
+    //       ||+------- UDRE0  USART Data Register Empty
+    //       |+-------- TXC0   USART Transmit Complete
+    //       +--------- RXC0   USART Receive Complete
+    UCSR0B = (1 << RXCIE0) | (0 << TXCIE0) | (0 << UDRIE0) | (1 << RXEN0) |
+        (1 << TXEN0) | (0 << UCSZ02) | (0 << TXB80);
+    //     0b10X110R0  (R: read-only bits)
+    //       |||||||+-- TXB80   Transmit Data Bit 8
+    //       ||||||+--- RXB80   Receive Data Bit 8
+    //       |||||+---- UCSZ02  Character Size  *see UCSR0C
+    //       ||||+----- TXEN0   Transmitter Enable: yes
+    //       |||+------ RXEN0   Receiver Enable: yes
+    //       ||+------- UDRIE0  Data Register Empty Interrupt Enable
+    //       |+-------- TXCIE0  TX Complete Interrupt Enable: no
+    //       +--------- RXCIE0  RX Complete Interrupt Enable: yes
+    UCSR0C = (0 << UMSEL01) | (0 << UMSEL00) | (0 << UPM01) | (0 << UPM00) |
+        (0 << USBS0) | (1 << UCSZ01) | (1 << UCSZ00) | (0 << UCPOL0);
+    //     0b00000110
+    //       |||||||+-- UCPOL0      Clock Polarity  *unused
+    //       |||||++--- UCSZ0<1:0>  Character Size: 8-bit
+    //       ||||+----- USBS0       USART Stop Bit Select: 1-bit
+    //       ||++------ UPM0<1:0>   USART Parity Mode: Disabled
+    //       ++-------- UMSEL0<1:0> USART Mode Select: Asynchronous USART
+
+    // 20e+6[Hz(CPU)] / 9600[baud] / 16 * 2[doubler]
+    // ... actual value is 260.42, error rate +0.16%; the rate configured
+    // ... is set after restoring configurations
+    hal_usart_set_baud(9600);
+}
+
+// Setup Two-wire Serial Interface
+void setup_twi() {
+    TWCR = (0 << TWINT) | (0 << TWEA) | (0 << TWSTA) | (0 << TWSTO) |
+        (1 << TWEN) | (0 << TWIE);
+    //     0b00XXR1-0  (-: reserved bits, R: read-only bits)
+    //       |||||| +-- TWIE   TWI Interrupt Enable: no, set per transaction
+    //       |||||+---- TWEN   TWI Enable: yes
+    //       ||||+----- TWWC   TWI Write Collision Flag
+    //       |||+------ TWSTO  TWI Stop Condition
+    //       ||+------- TWSTA  TWI Start Condition
+    //       |+-------- TWEA   TWI Enable Acknowledge: no
+    //       +--------- TWINT  TWI Interrupt Flag
+    TWSR = (0 << TWPS1) | (0 << TWPS0);
+    //     0bRRRRR-00  (-: reserved bits, R: read-only bits)
+    //       ||||| ++-- TWPS<1:0> TWI Prescaler: 1
+    //       +++++----- TWS<7:3>  TWI Status Bit
+    TWDR = 0x00;
+
+    // (20e+6[Hz(CPU)] / 100e+3[Hz(SCL)] - 16) / 1[prescaler] / 2
+    // ... actual value is 92, error rate 0.00%
+    TWBR = (F_CPU / 100000 - 16) / 1 / 2;
+}
+
+// Setup Analog to Digital Converter
+void setup_adc() {
+    ADMUX = (0 << REFS1) | (0 << REFS0) | (0 << ADLAR);
+    //     0b000-XXXX  (-: reserved bits)
+    //       ||| ++++-- MUX<3:0>  Analog Channel Selection
+    //       ||+------- ADLAR     ADC Left Adjust: no
+    //       ++-------- REFS<1:0> Reference Selection: AREF
+    ADCSRA = (1 << ADEN) | (0 << ADATE) | (0 << ADIE) | (0 << ADIF) |
+        (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+    //     0b1X0X0111
+    //       |||||+++-- ADPS<2:0> ADC Prescaler Select: 128
+    //       ||||+----- ADIE      ADC Interrupt Enable: no
+    //       |||+------ ADIF      ADC Interrupt Flag
+    //       ||+------- ADATE     ADC Auto Trigger Enable: no
+    //       |+-------- ADSC      ADC Start Conversion
+    //       +--------- ADEN      ADC Enable: yes
+    ADCSRB = (ADCSRB & 0x40) | (0 << ADTS2) | (0 << ADTS1) | (0 << ADTS0);
+    //     0b-?---000  (-: reserved bits, ?: bits used in other functions)
+    //        |   +++-- ADTS<2:0> ADC Auto Trigger Source  *unused
+    //        +-------- ACME      Analog Comparator Multiplexer Enable
+    DIDR0  = (0 << ADC5D) | (0 << ADC4D) | (0 << ADC3D) | (1 << ADC2D) |
+        (0 << ADC1D) | (0 << ADC0D);
+    //     0b--000100  (-: reserved bits)
+    //         ++++++-- ADC<5:0>D  ADC Digital Input Disable
+}
+
+// Timer/Counter 0 Compare Match A interrupt vector
+ISR(TIMER0_COMPA_vect) {
+    // Line to display for this time (0..15)
+    static uint8_t y = 0;
+    // Weight of binary code modulation bit-plane (1, 2, 4, 8)
+    static uint8_t weight = 1;
+    // Whether the line has any dots to light
+    static bool lit = false;
+#ifdef SINGLE_TIMER_ISR
+    // Half counts of Timer0 since the last tick
+    static uint16_t tick_phase = 0;
+#endif
+    // Serialized line to send to the display
+    volatile scanline_t* lp;
+    volatile uint8_t* dp;
+    // PORTD with latch, clock and serial data bits cleared
+    uint8_t portd;
+    // Timer1 count on entry, for the profiler
+    uint16_t t0 = profile_isr_begin();
+
+    trace_event_isr(TRACE_TIMER0, y);
+#ifdef SINGLE_TIMER_ISR
+    // Count the period just ended; a tick is 312.5 counts of Timer0, so
+    // ... periods are counted in half counts to keep ticks from drifting
+    tick_phase += 2 * (OCR0A + 1);
+#endif
+    // Set period of this bit-plane; the longer the heavier the weight
+    OCR0A = BCM_UNIT_COUNTS * weight - 1;
+    if (weight == 1) {
+        // Set output disabled during update of the line
+        PORTD |= (1 << PORTD7);
+        lp = &scan_front[y];
+        lit = !lp->blank;
+        if (lit) {
+            dp = lp->data;
+            portd = PORTD & 0x83;
+            // Send serialized line as 16-bit serial data;
+            // ... latch is kept low during the transfer
+            for (uint8_t i = 0; i < 16; i++) {
+                // Set clock to low and data at once
+                PORTD = portd | *dp++;
+                // Set clock to high; data is read by the display
+                PORTD |= (1 << PORTD5);
+            }
+            // Set latch to high; display is updated
+            PORTD |= (1 << PORTD6);
+        }
+    }
+    // Enable output only in bit-planes weighted by brightness;
+    // ... blank lines are left disabled without being sent
+    if (lit && (display_brightness & weight)) {
+        PORTD &= ~(1 << PORTD7);
+    } else {
+        PORTD |= (1 << PORTD7);
+    }
+
+    // Advance bit-plane
+    weight <<= 1;
+    if (weight > BCM_MAX_WEIGHT) {
+        weight = 1;
+        // Advance line
+        if (y == 15) {
+            y = 0;
+            // Flip scan line planes on frame boundary if requested
+            if (scan_swap_pending) {
+                scan_front = scan_front == scan_planes[0] ?
+                    scan_planes[1] : scan_planes[0];
+                scan_swap_pending = false;
+                bench_frame();
+            }
+        } else {
+            y++;
+        }
+    }
+#ifdef SINGLE_TIMER_ISR
+    // Tick after the line is updated, at most once per period as no
+    // ... period is as long as a tick; ticks lag by up to a period
+    if (tick_phase >= TICK_HALF_COUNTS) {
+        tick_phase -= TICK_HALF_COUNTS;
+        tick_isr();
+    }
+#endif
+    profile_isr_end(PROFILE_TIMER0, t0);
+}
@@ -5,24 +5,40 @@
  *  Target: ATmega328P, 20.000 MHz crystal oscillator
  */
 
+#include <stdbool.h>
 #include <stdint.h>
+#include "display.h"
 #include "light_sensor.h"
 
+// Get brightness level (1..BRIGHTNESS_MAX) linearly mapped from ADC result
+uint8_t adc_to_linear_brightness_level(uint16_t adc) {
+    uint16_t const step = (BRIGHTNESS_ADC_DARK - BRIGHTNESS_ADC_BRIGHT)
+        / (BRIGHTNESS_MAX - 1);
+    uint8_t result = 0;
+
+    if (adc >= BRIGHTNESS_ADC_DARK) {
+        result = 1;
+    } else if (adc <= BRIGHTNESS_ADC_BRIGHT) {
+        result = BRIGHTNESS_MAX;
+    } else {
+        result = 1 + (BRIGHTNESS_ADC_DARK - adc) / step;
+    }
+    return result;
+}
+
 // Get brightness level by ADC result, with hysteresis transition
 uint8_t adc_to_brightness_level(uint16_t adc, uint8_t c_level) {
     uint8_t result = 0;
-    uint16_t const lut_brightness_threshold[] = {
-        BRIGHTNESS_THRESHOLD0,
-        BRIGHTNESS_THRESHOLD1,
-        BRIGHTNESS_THRESHOLD2,
-        BRIGHTNESS_THRESHOLD3,
-        BRIGHTNESS_THRESHOLD4
-    };
-    
-    if (c_level != 0 && adc >= lut_brightness_threshold[c_level - 1]) {
-        result = c_level - 1;
-    } else if (c_level != 4 && adc <= lut_brightness_threshold[c_level + 1]) {
-        result = c_level + 1;
+    uint8_t level_up, level_down;
+
+    // Levels reached even if the ADC value is pulled back by hysteresis
+    level_up = adc_to_linear_brightness_level(adc + BRIGHTNESS_ADC_HYSTERESIS);
+    level_down = adc_to_linear_brightness_level(
+        adc >= BRIGHTNESS_ADC_HYSTERESIS ? adc - BRIGHTNESS_ADC_HYSTERESIS : 0);
+    if (level_up > c_level) {
+        result = level_up;
+    } else if (level_down < c_level) {
+        result = level_down;
     } else {
         result = c_level;
     }
@@ -8,13 +8,14 @@
 #ifndef LIGHT_SENSOR_H_
 #define LIGHT_SENSOR_H_
 
-// Thresholds of ADC value for brightness adjustment
-#define BRIGHTNESS_THRESHOLD0  1024  // Level    1 => 0
-#define BRIGHTNESS_THRESHOLD1   900  // Level 0, 2 => 1
-#define BRIGHTNESS_THRESHOLD2   800  // Level 1, 3 => 2
-#define BRIGHTNESS_THRESHOLD3   600  // Level 2, 4 => 3
-#define BRIGHTNESS_THRESHOLD4   300  // Level 3    => 4
+// ADC values at both ends of automatic brightness range;
+// ... levels are spread linearly in between
+#define BRIGHTNESS_ADC_DARK     1000  // and above => level 1
+#define BRIGHTNESS_ADC_BRIGHT    300  // and below => level BRIGHTNESS_MAX
+// Hysteresis of ADC value for brightness level transition
+#define BRIGHTNESS_ADC_HYSTERESIS  20
 
+uint8_t adc_to_linear_brightness_level(uint16_t adc);
 uint8_t adc_to_brightness_level(uint16_t adc, uint8_t c_level);
 
 #endif
@@ -0,0 +1,137 @@
+/*
+ * DotMatrixClock2018/marquee.c
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "display.h"
+#include "marquee.h"
+
+extern volatile uint32_t fb_back[16];
+
+// Initialize marquee with the window and timing parameters
+void marquee_initialize(marquee_t* m, uint8_t x, uint8_t width,
+    uint8_t speed, uint8_t pause) {
+    m->x = x;
+    m->width = width;
+    m->speed = speed;
+    m->pause = pause;
+    m->steps = 0;
+    marquee_set_text(m, "", false);
+}
+
+// Set source string and restart from its head
+void marquee_set_text(marquee_t* m, const char* s, bool progmem) {
+    m->s = s;
+    m->progmem = progmem;
+    marquee_restart(m);
+}
+
+// Fill the window from the head of text
+void marquee_restart(marquee_t* m) {
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; i < MARQUEE_HEIGHT; i++) {
+        m->lines[i] = 0ul;
+    }
+    m->pos = 0;
+    // Let the first column fetch a new glyph
+    m->g.width = 0;
+    m->col = 1;
+    // Stream columns until the window is filled or the text is exhausted
+    while (n < m->width && marquee_stream_column(m)) {
+        n++;
+    }
+    if (n < m->width) {
+        // Align whole text to the left of the window; lines of empty text
+        // ... are left zero, as shifting by the whole width of 32 dots is
+        // ... undefined
+        if (n > 0) {
+            for (uint8_t i = 0; i < MARQUEE_HEIGHT; i++) {
+                m->lines[i] <<= m->width - n;
+            }
+        }
+        m->state = MQ_STATIC;
+    } else {
+        m->state = MQ_PAUSE_HEAD;
+    }
+    m->count = 0;
+    m->steps++;
+}
+
+// Shift the window to the left by 1 dot and stream in the next column
+// ... return true on success, false if the text is exhausted
+bool marquee_stream_column(marquee_t* m) {
+    uint8_t c;
+    uint8_t b;
+
+    // Fetch the next glyph after the gap of current one
+    if (m->col > m->g.width) {
+        c = m->progmem ? pgm_read_byte(m->s + m->pos) : m->s[m->pos];
+        if (c == '\0') {
+            return false;
+        }
+        m->pos++;
+        display_get_glyph(FONT_PP05, c, &m->g);
+        m->col = 0;
+    }
+    for (uint8_t i = 0; i < MARQUEE_HEIGHT; i++) {
+        if (m->col < m->g.width) {
+            b = display_glyph_line(&m->g, i) >> (m->g.width - 1 - m->col);
+        } else {
+            b = 0;
+        }
+        m->lines[i] = (m->lines[i] << 1) | (b & 0x01);
+    }
+    m->col++;
+    return true;
+}
+
+// Advance marquee by a frame
+// ... return true if the window is changed
+bool marquee_update(marquee_t* m) {
+    bool changed = false;
+
+    switch (m->state) {
+    case MQ_STATIC:
+        break;
+    case MQ_PAUSE_HEAD:
+        if (++m->count >= m->pause) {
+            m->state = MQ_SCROLL;
+            m->count = 0;
+        }
+        break;
+    case MQ_SCROLL:
+        if (++m->count >= m->speed) {
+            m->count = 0;
+            if (marquee_stream_column(m)) {
+                m->steps++;
+                changed = true;
+            } else {
+                // Pause on the tail of text
+                m->state = MQ_PAUSE_TAIL;
+            }
+        }
+        break;
+    case MQ_PAUSE_TAIL:
+        if (++m->count >= m->pause) {
+            marquee_restart(m);
+            changed = true;
+        }
+        break;
+    }
+    return changed;
+}
+
+// Draw the window of marquee at specified line
+void marquee_draw(marquee_t* m, uint8_t y) {
+    uint32_t mask = m->width >= 32 ? ~0ul : (1ul << m->width) - 1;
+
+    for (uint8_t i = 0; i < MARQUEE_HEIGHT; i++) {
+        fb_back[y + i] |= (m->lines[i] & mask) << (m->x - (m->width - 1));
+    }
+}
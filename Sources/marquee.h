@@ -0,0 +1,62 @@
+/*
+ * DotMatrixClock2018/marquee.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#ifndef MARQUEE_H_
+#define MARQUEE_H_
+
+// Height of marquee lines; text is drawn in font PP05
+#define MARQUEE_HEIGHT  5
+
+// Enumeration table of marquee states
+typedef enum {
+    // Text fits in the window and stays still
+    MQ_STATIC,
+    // Pausing with the head of text shown
+    MQ_PAUSE_HEAD,
+    // Scrolling to the left
+    MQ_SCROLL,
+    // Pausing with the tail of text shown
+    MQ_PAUSE_TAIL
+} mqstate_t;
+
+// Horizontal marquee
+typedef struct {
+    // Source string
+    const char* s;
+    // Whether the source string is in program memory
+    bool progmem;
+    // Index of the next character to stream in
+    uint8_t pos;
+    // Glyph currently streaming in
+    glyph_t g;
+    // Next column of the glyph to stream in (g.width: 1-dot gap)
+    uint8_t col;
+    // Lines in the window; LSB is the rightmost column
+    uint32_t lines[MARQUEE_HEIGHT];
+    // Leftmost column and width of the window (1..32)
+    uint8_t x;
+    uint8_t width;
+    // Frames per 1-dot scroll
+    uint8_t speed;
+    // Frames to pause at both ends of text
+    uint8_t pause;
+    // Current state and frame count in the state
+    mqstate_t state;
+    uint8_t count;
+    // Count of window changes, to be compared by callers for redraw
+    uint8_t steps;
+} marquee_t;
+
+void marquee_initialize(marquee_t* m, uint8_t x, uint8_t width,
+    uint8_t speed, uint8_t pause);
+void marquee_set_text(marquee_t* m, const char* s, bool progmem);
+void marquee_restart(marquee_t* m);
+bool marquee_stream_column(marquee_t* m);
+bool marquee_update(marquee_t* m);
+void marquee_draw(marquee_t* m, uint8_t y);
+
+#endif
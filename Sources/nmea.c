@@ -9,644 +9,585 @@
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
-#include <avr/io.h>
+#include <avr/pgmspace.h>
 #include "ctime.h"
 #include "nmea.h"
 
+// Sentence type and its conversion
+typedef struct {
+    // Characters of the type following the talker
+    char type[3];
+    // Fields in the sentence; later versions of NMEA add some
+    uint8_t fields_min;
+    uint8_t fields_max;
+    // Convert a field just ended into the result
+    // ... return true if the field is invalid, false if valid
+    bool (*end_field)(nmea_t* p);
+    // Finish the result when the sentence is validated, or NULL
+    void (*finish)(nmea_t* p);
+} nmea_type_t;
+
 // Look-up table for power of ten
 uint16_t const lut_pow10[] = { 1, 10, 100, 1000, 10000 };
 
-// Check isdigit() to multiple characters
-// ... return true if all checked characters are decimal digit, false otherwise
-inline bool isdigitn(uint8_t* s, uint16_t n) {
-    bool result = true;
+// Convert hexadecimal digit character to binary
+inline uint8_t c2b(uint8_t c) {
+    uint8_t result = 0;
 
-    for (uint16_t i = 0; i < n; i++) {
-        if (!isdigit(*s++)) {
-            result = false;
-        }
+    if (c >= '0' && c <= '9') {
+        result = c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+        result = 10 + c - 'A';
+    } else if (c >= 'a' && c <= 'f') {
+        result = 10 + c - 'a';
     }
     return result;
 }
 
-// Check isxdigit() to multiple characters
-// ... return true if all checked characters are hexadecimal digit, false otherwise
-inline bool isxdigitn(uint8_t* s, uint16_t n) {
-    bool result = true;
+// Initialize parser with handlers indexed by nmea_sentence_t, in program
+// ... memory
+void nmea_initialize(nmea_t* p, const nmea_handler_t* handlers) {
+    p->handlers = handlers;
+    nmea_reset(p);
+}
+
+// Abandon the sentence being parsed, and wait for the next one
+void nmea_reset(nmea_t* p) {
+    p->part = NMEA_PART_NONE;
+    p->sentence = NMEA_NONE;
+}
+
+// Clear the field being parsed
+void nmea_clear_field(nmea_t* p) {
+    p->length = 0;
+    p->dot = false;
+    p->sign = false;
+    p->other = false;
+    p->nonhex = false;
+    p->digits = 0;
+    p->fraction_digits = 0;
+    p->integer = 0;
+    p->fraction = 0;
+    p->hex = 0;
+}
 
-    for (uint16_t i = 0; i < n; i++) {
-        if (!isxdigit(*s++)) {
-            result = false;
+// Add a character to the field being parsed
+void nmea_add_char(nmea_t* p, uint8_t c) {
+    if (p->length < sizeof(p->text)) {
+        p->text[p->length] = c;
+    }
+    if (p->length != UINT8_MAX) {
+        p->length++;
+    }
+    if (isdigit(c)) {
+        if (p->dot) {
+            if (p->fraction_digits < 4) {
+                p->fraction += (c - '0') * lut_pow10[3 - p->fraction_digits];
+            }
+            if (p->fraction_digits != UINT8_MAX) {
+                p->fraction_digits++;
+            }
+        } else {
+            if (p->digits < 9) {
+                p->integer = p->integer * 10 + (c - '0');
+            }
+            if (p->digits != UINT8_MAX) {
+                p->digits++;
+            }
+        }
+    } else if (c == '.' && !p->dot) {
+        p->dot = true;
+        p->nonhex = true;
+    } else if (c == '-' && p->length == 1) {
+        p->sign = true;
+        p->nonhex = true;
+    } else {
+        p->other = true;
+        if (!isxdigit(c)) {
+            p->nonhex = true;
         }
     }
-    return result;
+    p->hex = p->hex << 4 | c2b(c);
+}
+
+// Get the field as an unsigned number of up to 5 integer digits
+// ... return true if the field is invalid, false if valid or empty
+bool nmea_field_decimal(nmea_t* p, nmea_decimal_t* d) {
+    d->integer = p->integer;
+    d->fraction = p->fraction;
+    return p->length && (p->other || p->sign || p->digits > 5);
+}
+
+// Get the field as latitude, longitude or magnetic variation, leaving its
+// ... direction
+// ... return true if the field is invalid, false if valid or empty
+bool nmea_field_coordinate(nmea_t* p, nmea_coordinate_t* co) {
+    co->integer = p->integer;
+    co->fraction = p->fraction;
+    return p->length && (p->other || p->sign || p->digits > 5);
+}
+
+// Get the field as a height, a signed number of up to 5 integer digits,
+// ... leaving its units
+// ... return true if the field is invalid, false if valid or empty
+bool nmea_field_height(nmea_t* p, nmea_height_t* h) {
+    h->sign = p->sign;
+    h->integer = p->integer;
+    h->fraction = p->fraction;
+    return p->length && (p->other || p->digits > 5);
 }
 
-// Count consecutive decimal digits in string
-inline uint16_t consecutive_digits(uint8_t* s) {
-    uint16_t result = 0;
+// Get the field as a character, or a default one if empty
+// ... return true if the field is invalid, false if valid or empty
+bool nmea_field_char(nmea_t* p, uint8_t* c, uint8_t c_default) {
+    *c = p->length ? p->text[0] : c_default;
+    return p->length > 1;
+}
 
-    while (*s && isdigit(*s++)) {
-        result++;
+// Get the field as a count of up to 3 digits
+// ... return true if the field is invalid, false if valid or empty
+bool nmea_field_count(nmea_t* p, uint8_t* n) {
+    *n = p->integer;
+    return p->length && (p->length != p->digits || p->digits > 3);
+}
+
+// Get the field as a station ID of 4 hexadecimal digits, or 0 if empty
+// ... return true if the field is invalid, false if valid or empty
+bool nmea_field_station(nmea_t* p, uint16_t* id) {
+    *id = p->length ? p->hex : 0x0000;
+    return p->length && (p->length != 4 || p->nonhex);
+}
+
+// Check the field is exactly of the count of digits
+inline bool nmea_field_digits(nmea_t* p, uint8_t n) {
+    return p->length == n && p->digits == n;
+}
+
+// Get the field as clock time of "hhmmss" optionally followed by
+// ... sub-seconds
+// ... return true if the field is invalid, false if valid
+bool nmea_field_time(nmea_t* p, ctime_t* ct) {
+    if (p->other || p->sign || p->digits != 6) {
+        return true;
     }
-    return result;
+    ct->h = p->integer / 10000;
+    ct->m = p->integer / 100 % 100;
+    ct->s = p->integer % 100;
+    ct->ms = p->fraction / 10;
+    return ct->h > 23 || ct->m > 59 || ct->s > 59;
 }
 
-// Convert hexadecimal digit character to binary
-inline uint8_t c2b(uint8_t c) {
-    uint8_t result = 0;
+// Convert the field just ended into the result of $__GGA
+// ... return true if the field is invalid, false if valid
+bool nmea_end_gga_field(nmea_t* p) {
+    gga_t* gga = &p->result.gga;
 
-    if (c >= '0' && c <= '9') {
-        result = c - '0';
-    } else if (c >= 'A' && c <= 'F') {
-        result = 10 + c - 'A';
-    } else if (c >= 'a' && c <= 'f') {
-        result = 10 + c - 'a';
+    switch (p->field) {
+    case GGA_TIME:
+        return nmea_field_time(p, &gga->ct);
+    case GGA_LATITUDE:
+        return nmea_field_coordinate(p, &gga->latitude);
+    case GGA_LATITUDE_DIRECTION:
+        return nmea_field_char(p, &gga->latitude.direction, 'N');
+    case GGA_LONGITUDE:
+        return nmea_field_coordinate(p, &gga->longitude);
+    case GGA_LONGITUDE_DIRECTION:
+        return nmea_field_char(p, &gga->longitude.direction, 'E');
+    case GGA_STATUS:
+        gga->status = p->integer;
+        return !nmea_field_digits(p, 1);
+    case GGA_SATS_IN_USE:
+        return nmea_field_count(p, &gga->sats_in_use);
+    case GGA_HDOP:
+        return nmea_field_decimal(p, &gga->hdop);
+    case GGA_HEIGHT:
+        return nmea_field_height(p, &gga->height);
+    case GGA_HEIGHT_UNITS:
+        return nmea_field_char(p, &gga->height.units, 'M');
+    case GGA_GEOID_SEPARATION:
+        return nmea_field_height(p, &gga->geoid_separation);
+    case GGA_GEOID_SEPARATION_UNITS:
+        return nmea_field_char(p, &gga->geoid_separation.units, 'M');
+    case GGA_DGPS_AGE:
+        return nmea_field_decimal(p, &gga->dgps_age);
+    case GGA_DGPS_STATION_ID:
+        return nmea_field_station(p, &gga->dgps_station_id);
+    default:
+        return false;
     }
-    return result;
 }
 
-// Parse and validate $__GGA message and pack to data structure
-// ... return true if the message is invalid, false if valid
-bool parse_gga(gga_t* gga, uint8_t* s, uint16_t count) {
-    bool valid = true;
-    gga_t gga0;
-    uint8_t fn = 0;
-    uint8_t field_count = 0;
-    uint8_t field[11];
-    uint8_t checksum_expected, checksum_given = 0x00;
-    uint8_t c, cd = 0, cp = 0;
-
-    checksum_expected = 'G' ^ 'P' ^ 'G' ^ 'G' ^ 'A' ^ ',';
-    for (uint16_t j = 0; j < count && (c = *s++) != '\n'; j++) {
-        if (c == ',' || c == '*' || c == '\r') {
-            field[field_count] = '\0';
-            switch (fn) {
-            case 0:
-                // UTC clock time
-                if (valid) {
-                    valid = field_count >= 6;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isdigitn(&field[cp], 6);
-                }
-                if (valid) {
-                    gga0.ct.h = c2b(field[cp]) * 10 + c2b(field[cp + 1]);
-                    gga0.ct.m = c2b(field[cp + 2]) * 10 + c2b(field[cp + 3]);
-                    gga0.ct.s = c2b(field[cp + 4]) * 10 + c2b(field[cp + 5]);
-                    cp += 6;
-                    gga0.ct.ms = 0;
-                    valid = gga0.ct.h <= 23 && gga0.ct.m <= 59 &&
-                        gga0.ct.s <= 59;
-                }
-                if (valid && field_count >= 7 && field[cp++] == '.') {
-                    cd = consecutive_digits(&field[cp]);
-                    
-                    for (uint16_t i = 0; i < cd; i++) {
-                        gga0.ct.ms += (uint16_t) c2b(field[cp++])
-                            * lut_pow10[2 - i];
-                    }
-                }
-                break;
-            case 1:
-                // Absolute value of latitude (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count >= 6;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        cd = consecutive_digits(&field[cp]);
-                        valid = cd <= 5;
-                    }
-                    gga0.latitude.integer = 0;
-                    gga0.latitude.fraction = 0;
-                }
-                if (valid && field_count) {
-                    for (uint16_t i = cd - 1; i < cd; i--) {
-                        gga0.latitude.integer += c2b(field[cp++])
-                            * lut_pow10[i];
-                    }
-                    if (field[cp++] == '.') {
-                        cd = consecutive_digits(&field[cp]);
-                        for (uint16_t i = 0; i < cd && i < 4; i++) {
-                            gga0.latitude.fraction += c2b(field[cp++])
-                                * lut_pow10[3 - i];
-                        }
-                    }
-                }
-                break;
-            case 2:
-                // Direction of latitude (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count == 1;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        gga0.latitude.direction = field[cp++];
-                    } else {
-                        gga0.latitude.direction = 'N';
-                    }
-                }
-                break;
-            case 3:
-                // Absolute value of latitude (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count >= 6;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        cd = consecutive_digits(&field[cp]);
-                        valid = cd <= 5;
-                    }
-                    gga0.longitude.integer = 0;
-                    gga0.longitude.fraction = 0;
-                }
-                if (valid && field_count) {
-                    for (uint16_t i = cd - 1; i < cd; i--) {
-                        gga0.longitude.integer += c2b(field[cp++])
-                            * lut_pow10[i];
-                    }
-                    if (field[cp++] == '.') {
-                        cd = consecutive_digits(&field[cp]);
-                        for (uint16_t i = 0; i < cd && i < 4; i++) {
-                            gga0.longitude.fraction += c2b(field[cp++])
-                                * lut_pow10[3 - i];
-                        }
-                    }
-                }
-                break;
-            case 4:
-                // Direction of longitude (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count == 1;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        gga0.longitude.direction = field[cp++];
-                    } else {
-                        gga0.longitude.direction = 'E';
-                    }
-                }
-                break;
-            case 5:
-                // Position fix status
-                if (valid) {
-                    valid = field_count == 1;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isdigit(field[cp]);
-                }
-                if (valid) {
-                    gga0.status = c2b(field[cp++]);
-                }
-                break;
-            case 6:
-                // Satellites in use (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count <= 3;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        cd = consecutive_digits(&field[cp]);
-                        valid = cd >= 1 && cd <= 3;
-                    }
-                    gga0.sats_in_use = 0;
-                }
-                if (valid && field_count) {
-                    for (uint16_t i = cd - 1; i < cd; i--) {
-                        gga0.sats_in_use += c2b(field[cp++]) * lut_pow10[i];
-                    }
-                }
-                break;
-            case 7:
-                // HDOP (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count <= 10;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        cd = consecutive_digits(&field[cp]);
-                        valid = cd <= 5;
-                    }
-                    gga0.hdop.integer = 0;
-                    gga0.hdop.fraction = 0;
-                }
-                if (valid && field_count) {
-                    for (uint16_t i = cd - 1; i < cd; i--) {
-                        gga0.hdop.integer += c2b(field[cp++])
-                            * lut_pow10[i];
-                    }
-                    if (field[cp++] == '.') {
-                        cd = consecutive_digits(&field[cp]);
-                        for (uint16_t i = 0; i < cd && i < 4; i++) {
-                            gga0.hdop.fraction += c2b(field[cp++])
-                                * lut_pow10[3 - i];
-                        }
-                    }
-                }
-                break;
-            case 8:
-                // Value of MSL orthometric height (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count <= 10;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        valid = isdigit(field[cp]) || field[cp] == '-';
-                        if (field[cp] == '-') {
-                            gga0.height.sign = 1;
-                            cp += 1;
-                        } else {
-                            gga0.height.sign = 0;
-                        }
-                        cd = consecutive_digits(&field[cp]);
-                        valid = valid && cd <= 5;
-                    } else {
-                        gga0.height.sign = 0;
-                    }
-                    gga0.height.integer = 0;
-                    gga0.height.fraction = 0;
-                }
-                if (valid && field_count) {
-                    for (uint16_t i = cd - 1; i < cd; i--) {
-                        gga0.height.integer += c2b(field[cp++])
-                            * lut_pow10[i];
-                    }
-                    if (field[cp++] == '.') {
-                        cd = consecutive_digits(&field[cp]);
-                        for (uint16_t i = 0; i < cd && i < 4; i++) {
-                            gga0.height.fraction += c2b(field[cp++])
-                                * lut_pow10[3 - i];
-                        }
-                    }
-                }
-                break;
-            case 9:
-                // Units of MSL orthometric height (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count == 1;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        gga0.height.units= field[cp++];
-                    } else {
-                        gga0.height.units = 'M';
-                    }
-                }
-                break;
-            case 10:
-                // Value of geoid separation (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count <= 10;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        valid = isdigit(field[cp]) || field[cp] == '-';
-                        if (field[cp] == '-') {
-                            gga0.geoid_separation.sign = 1;
-                            cp += 1;
-                        } else {
-                            gga0.geoid_separation.sign = 0;
-                        }
-                        cd = consecutive_digits(&field[cp]);
-                        valid = valid && cd <= 5;
-                    } else {
-                        gga0.geoid_separation.sign = 0;
-                    }
-                    gga0.geoid_separation.integer = 0;
-                    gga0.geoid_separation.fraction = 0;
-                }
-                if (valid && field_count) {
-                    for (uint16_t i = cd - 1; i < cd; i--) {
-                        gga0.geoid_separation.integer += c2b(field[cp++])
-                            * lut_pow10[i];
-                    }
-                    if (field[cp++] == '.') {
-                        cd = consecutive_digits(&field[cp]);
-                        for (uint16_t i = 0; i < cd && i < 4; i++) {
-                            gga0.geoid_separation.fraction += c2b(field[cp++])
-                                * lut_pow10[3 - i];
-                        }
-                    }
-                }
-                break;
-            case 11:
-                // Units of geoid separation (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count == 1;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        gga0.geoid_separation.units= field[cp++];
-                    } else {
-                        gga0.geoid_separation.units = 'M';
-                    }
-                }
-                break;
-            case 12:
-                // Age of DGPS data in seconds (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count <= 10;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        cd = consecutive_digits(&field[cp]);
-                        valid = cd <= 5;
-                    }
-                    gga0.dgps_age.integer = 0;
-                    gga0.dgps_age.fraction = 0;
-                }
-                if (valid && field_count) {
-                    for (uint16_t i = cd - 1; i < cd; i--) {
-                        gga0.dgps_age.integer += c2b(field[cp++])
-                            * lut_pow10[i];
-                    }
-                    if (field[cp++] == '.') {
-                        cd = consecutive_digits(&field[cp]);
-                        for (uint16_t i = 0; i < cd && i < 4; i++) {
-                            gga0.dgps_age.fraction += c2b(field[cp++])
-                                * lut_pow10[3 - i];
-                        }
-                    }
-                }
-                break;
-            case 13:
-                // DGPS reference station ID (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count == 4;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        valid = isxdigitn(&field[cp], 4);
-                    } else {
-                        gga0.dgps_station_id = 0x0000;
-                    }
-                }
-                if (valid && field_count) {
-                    gga0.dgps_station_id = (uint16_t) c2b(field[cp]) << 12
-                        | (uint16_t) c2b(field[cp + 1]) << 8
-                        | (uint16_t) c2b(field[cp + 2]) << 4
-                        | c2b(field[cp + 3]);
-                    cp += 4;
-                }
-                break;
-            case 14:
-                // Checksum
-                if (valid) {
-                    valid = field_count == 2;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isxdigitn(&field[cp], 2);
-                }
-                if (valid) {
-                    checksum_given = c2b(field[cp]) * 16 + c2b(field[cp + 1]);
-                    cp += 2;
-                }
-                break;
-            default:
-                break;
+// Convert the field just ended into the result of $__GNS
+// ... return true if the field is invalid, false if valid
+bool nmea_end_gns_field(nmea_t* p) {
+    gns_t* gns = &p->result.gns;
+    uint8_t n = p->length < 4 ? p->length : 4;
+
+    switch (p->field) {
+    case GNS_TIME:
+        return nmea_field_time(p, &gns->ct);
+    case GNS_LATITUDE:
+        return nmea_field_coordinate(p, &gns->latitude);
+    case GNS_LATITUDE_DIRECTION:
+        return nmea_field_char(p, &gns->latitude.direction, 'N');
+    case GNS_LONGITUDE:
+        return nmea_field_coordinate(p, &gns->longitude);
+    case GNS_LONGITUDE_DIRECTION:
+        return nmea_field_char(p, &gns->longitude.direction, 'E');
+    case GNS_MODE:
+        // A character per constellation; the best of them tells the status
+        // ... in values of $__GGA, where precise and RTK modes are a fix
+        for (uint8_t i = 0; i < n; i++) {
+            gns->mode[i] = p->text[i];
+            if (p->text[i] == 'D') {
+                gns->status = 2;
+            } else if (gns->status == 0 && (p->text[i] == 'A' ||
+                p->text[i] == 'P' || p->text[i] == 'R' ||
+                p->text[i] == 'F')) {
+                gns->status = 1;
             }
-            fn++;
-            field_count = 0;
-        } else {
-            field[field_count++] = c;
         }
-        // Calculate checksum
-        if (fn < 14) {
-            checksum_expected ^= c;
+        return p->length == 0 || p->digits || p->dot || p->sign;
+    case GNS_SATS_IN_USE:
+        return nmea_field_count(p, &gns->sats_in_use);
+    case GNS_HDOP:
+        return nmea_field_decimal(p, &gns->hdop);
+    case GNS_HEIGHT:
+        gns->height.units = 'M';
+        return nmea_field_height(p, &gns->height);
+    case GNS_GEOID_SEPARATION:
+        gns->geoid_separation.units = 'M';
+        return nmea_field_height(p, &gns->geoid_separation);
+    case GNS_DGPS_AGE:
+        return nmea_field_decimal(p, &gns->dgps_age);
+    case GNS_DGPS_STATION_ID:
+        return nmea_field_station(p, &gns->dgps_station_id);
+    case GNS_NAV_STATUS:
+        return nmea_field_char(p, &gns->nav_status, '\0');
+    default:
+        return false;
+    }
+}
+
+// Convert the field just ended into the result of $__GSA
+// ... return true if the field is invalid, false if valid
+bool nmea_end_gsa_field(nmea_t* p) {
+    gsa_t* gsa = &p->result.gsa;
+
+    if (p->field >= GSA_SAT_FIRST && p->field <= GSA_SAT_LAST) {
+        // Satellite IDs are counted, not kept
+        if (p->length) {
+            gsa->sats_in_use++;
         }
+        return p->length && (p->length != p->digits || p->digits > 3);
     }
-    gga0.checksum_expected = checksum_expected;
-    gga0.checksum_given = checksum_given;
-    if (valid) {
-        valid = checksum_given == checksum_expected;
+    switch (p->field) {
+    case GSA_SELECTION:
+        return nmea_field_char(p, &gsa->selection, 'A');
+    case GSA_FIX:
+        gsa->fix = p->integer;
+        return !nmea_field_digits(p, 1) || gsa->fix < 1 || gsa->fix > 3;
+    case GSA_PDOP:
+        return nmea_field_decimal(p, &gsa->pdop);
+    case GSA_HDOP:
+        return nmea_field_decimal(p, &gsa->hdop);
+    case GSA_VDOP:
+        return nmea_field_decimal(p, &gsa->vdop);
+    case GSA_SYSTEM_ID:
+        gsa->system_id = p->length ? p->hex : 0;
+        return p->length && (p->length != 1 || p->nonhex);
+    default:
+        return false;
     }
-    if (valid) {
-        *gga = gga0;
+}
+
+// Convert the field just ended into the result of $__RMC
+// ... return true if the field is invalid, false if valid
+bool nmea_end_rmc_field(nmea_t* p) {
+    rmc_t* rmc = &p->result.rmc;
+
+    switch (p->field) {
+    case RMC_TIME:
+        return nmea_field_time(p, &rmc->ct);
+    case RMC_STATUS:
+        return nmea_field_char(p, &rmc->status, 'V');
+    case RMC_LATITUDE:
+        return nmea_field_coordinate(p, &rmc->latitude);
+    case RMC_LATITUDE_DIRECTION:
+        return nmea_field_char(p, &rmc->latitude.direction, 'N');
+    case RMC_LONGITUDE:
+        return nmea_field_coordinate(p, &rmc->longitude);
+    case RMC_LONGITUDE_DIRECTION:
+        return nmea_field_char(p, &rmc->longitude.direction, 'E');
+    case RMC_SPEED:
+        return nmea_field_decimal(p, &rmc->speed);
+    case RMC_COURSE:
+        return nmea_field_decimal(p, &rmc->course);
+    case RMC_DATE:
+        // "ddmmyy"
+        rmc->ct.d = p->integer / 10000;
+        rmc->ct.mo = p->integer / 100 % 100;
+        rmc->ct.yh = p->integer / 10 % 10;
+        rmc->ct.yl = p->integer % 10;
+        return !nmea_field_digits(p, 6) || rmc->ct.mo < 1 ||
+            rmc->ct.mo > 12 || rmc->ct.d < 1 ||
+            rmc->ct.d > days_in_month(&rmc->ct);
+    case RMC_VARIATION:
+        return nmea_field_coordinate(p, &rmc->variation);
+    case RMC_VARIATION_DIRECTION:
+        return nmea_field_char(p, &rmc->variation.direction, 'E');
+    case RMC_MODE:
+        return nmea_field_char(p, &rmc->mode, '\0');
+    case RMC_NAV_STATUS:
+        return nmea_field_char(p, &rmc->nav_status, '\0');
+    default:
+        return false;
     }
-    return valid == false;
 }
 
-// Parse and validate $__ZDA message and get represented clock time
-// ... return true if the message is invalid, false if valid
-bool parse_zda(zda_t* zda, uint8_t* s, uint16_t count) {
-    bool valid = true;
-    zda_t zda0;
-    struct {
-        bool sign;
-        uint8_t h, m;
-    } ct_offset = { 0, 0, 0 };
-    uint8_t fn = 0;
-    uint8_t field_count = 0;
-    uint8_t field[11];
-    uint8_t checksum_expected, checksum_given = 0x00;
-    uint8_t c, cd = 0, cp = 0;
-
-    checksum_expected = 'G' ^ 'P' ^ 'Z' ^ 'D' ^ 'A' ^ ',';
-    for (uint16_t i = 0; i < count && (c = *s++) != '\n'; i++) {
-        if (c == ',' || c == '*' || c == '\r') {
-            field[field_count] = '\0';
-            switch (fn) {
-            case 0:
-                // Hours, minutes, seconds, sub-seconds (optional)
-                if (valid) {
-                    valid = field_count >= 6;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isdigitn(&field[cp], 6);
-                }
-                if (valid) {
-                    zda0.ct.h = c2b(field[cp]) * 10 + c2b(field[cp + 1]);
-                    zda0.ct.m = c2b(field[cp + 2]) * 10 + c2b(field[cp + 3]);
-                    zda0.ct.s = c2b(field[cp + 4]) * 10 + c2b(field[cp + 5]);
-                    cp += 6;
-                    zda0.ct.ms = 0;
-                    valid = zda0.ct.h <= 23 && zda0.ct.m <= 59 &&
-                        zda0.ct.s <= 59;
-                }
-                if (valid && field_count >= 7 && field[cp++] == '.') {
-                    cd = consecutive_digits(&field[cp]);
-                    for (uint16_t i = 0; i < cd; i++) {
-                        zda0.ct.ms += (uint16_t) c2b(field[cp++])
-                            * lut_pow10[2 - i];
-                    }
-                }
-                break;
-            case 1:
-                // Days
-                if (valid) {
-                    valid = field_count == 2;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isdigitn(&field[cp], 2);
-                }
-                if (valid) {
-                    zda0.ct.d = c2b(field[cp]) * 10 + c2b(field[cp + 1]);
-                    cp += 2;
-                }
-                break;
-            case 2:
-                // Months
-                if (valid) {
-                    valid = field_count == 2;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isdigitn(&field[cp], 2);
-                }
-                if (valid) {
-                    zda0.ct.mo = c2b(field[cp]) * 10 + c2b(field[cp + 1]);
-                    cp += 2;
-                    valid = zda0.ct.mo >= 1 && zda0.ct.mo <= 12;
-                }
-                break;
-            case 3:
-                // Years
-                if (valid) {
-                    valid = field_count == 4;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isdigitn(&field[cp], 4);
-                }
-                if (valid) {
-                    cp += 2;
-                    zda0.ct.yh = c2b(field[cp++]);
-                    zda0.ct.yl = c2b(field[cp++]);
-                    valid = zda0.ct.yh <= 9 && zda0.ct.yl <= 9 &&
-                        zda0.ct.d >= 1 && zda0.ct.d <= days_in_month(&zda0.ct);
-                }
-                break;
-            case 4:
-                // Local time offset hours (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count == 2
-                        || field_count == 3;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        valid = isdigit(field[cp]) || field[cp] == '-';
-                        if (field[cp] == '-') {
-                            ct_offset.sign = 1;
-                            cp += 1;
-                        } else {
-                            ct_offset.sign = 0;
-                        }
-                        cd = consecutive_digits(&field[cp]);
-                        valid = valid && cd == 2;
-                    } else {
-                        ct_offset.sign = 0;
-                    }
-                }
-                if (valid && field_count) {
-                    ct_offset.h = c2b(field[cp]) * 10 + c2b(field[cp + 1]);
-                    cp += 2;
-                    valid = ct_offset.h <= 13;
-                }
-                break;
-            case 5:
-                // Local time offset minutes (optional)
-                if (valid) {
-                    valid = field_count == 0 || field_count == 2;
-                    cp = 0;
-                }
-                if (valid) {
-                    if (field_count) {
-                        valid = isdigitn(&field[cp], 2);
-                    } else {
-                        ct_offset.m = 0;
-                    }
-                }
-                if (valid && field_count) {
-                    ct_offset.m = c2b(field[cp]) * 10 + c2b(field[cp + 1]);
-                    cp += 2;
-                    valid = ct_offset.m <= 59;
-                }
-                break;
-            case 6:
-                // Checksum
-                if (valid) {
-                    valid = field_count == 2;
-                    cp = 0;
-                }
-                if (valid) {
-                    valid = isxdigitn(&field[cp], 2);
-                }
-                if (valid) {
-                    checksum_given = c2b(field[cp]) * 16 + c2b(field[cp + 1]);
-                    cp += 2;
-                }
-                break;
-            default:
-                break;
-            }
-            fn++;
-            field_count = 0;
-        } else {
-            field[field_count++] = c;
+// Convert the field just ended into the result of $__ZDA
+// ... return true if the field is invalid, false if valid
+bool nmea_end_zda_field(nmea_t* p) {
+    zda_t* zda = &p->result.zda;
+
+    switch (p->field) {
+    case ZDA_TIME:
+        return nmea_field_time(p, &zda->ct);
+    case ZDA_DAY:
+        zda->ct.d = p->integer;
+        return !nmea_field_digits(p, 2);
+    case ZDA_MONTH:
+        zda->ct.mo = p->integer;
+        return !nmea_field_digits(p, 2) || zda->ct.mo < 1 || zda->ct.mo > 12;
+    case ZDA_YEAR:
+        zda->ct.yh = p->integer / 10 % 10;
+        zda->ct.yl = p->integer % 10;
+        if (!nmea_field_digits(p, 4)) {
+            return true;
         }
-        // Calculate checksum
-        if (fn < 6) {
-            checksum_expected ^= c;
+        // Check the day when the month is also taken
+        if ((p->handler.fields & (1 << ZDA_DAY)) &&
+            (p->handler.fields & (1 << ZDA_MONTH))) {
+            return zda->ct.d < 1 || zda->ct.d > days_in_month(&zda->ct);
         }
+        return false;
+    case ZDA_OFFSET_HOURS:
+        // Local time offset is checked, but not used
+        return p->length && (p->other || p->dot || p->digits != 2 ||
+            p->integer > 13);
+    case ZDA_OFFSET_MINUTES:
+        return p->length && (!nmea_field_digits(p, 2) || p->integer > 59);
+    default:
+        return false;
     }
-    zda0.checksum_expected = checksum_expected;
-    zda0.checksum_given = checksum_given;
-    if (valid) {
-        valid = checksum_given == checksum_expected;
-        // Force set local time to JST (UTC+9)
-        ct_offset.sign = 0;
-        ct_offset.h = 9;
-        ct_offset.m = 0;
+}
+
+// Finish $__RMC sentence validated
+void nmea_finish_rmc(nmea_t* p) {
+    if (p->handler.fields & (1 << RMC_TIME)) {
+        ctime_localize(&p->result.rmc.ct,
+            p->handler.fields & (1 << RMC_DATE));
+    }
+}
+
+// Finish $__ZDA sentence validated; the offset given is not used
+void nmea_finish_zda(nmea_t* p) {
+    if (p->handler.fields & (1 << ZDA_TIME)) {
+        ctime_localize(&p->result.zda.ct,
+            p->handler.fields & (1 << ZDA_YEAR));
+    }
+}
+
+// Sentence types by nmea_sentence_t from NMEA_GGA; types sharing their
+// ... first characters are adjacent, so that the address is matched a
+// ... character at a time. A sentence is added by an entry here with its
+// ... field enumeration and result structure
+PROGMEM nmea_type_t const nmea_types[NMEA_SENTENCE_COUNT - NMEA_GGA] = {
+    { "GGA", 14, 14, nmea_end_gga_field, NULL },
+    { "GNS", 12, 13, nmea_end_gns_field, NULL },
+    { "GSA", 17, 18, nmea_end_gsa_field, NULL },
+    { "RMC", 11, 13, nmea_end_rmc_field, nmea_finish_rmc },
+    { "ZDA",  6,  6, nmea_end_zda_field, nmea_finish_zda }
+};
+
+// Tell the talker of the first 2 characters of the address
+nmea_talker_t nmea_talker(uint8_t c0, uint8_t c1) {
+    switch (c0) {
+    case 'B':
+        return c1 == 'D' ? NMEA_TALKER_BD : NMEA_TALKER_NONE;
+    case 'G':
+        switch (c1) {
+        case 'A':
+            return NMEA_TALKER_GA;
+        case 'B':
+            return NMEA_TALKER_GB;
+        case 'L':
+            return NMEA_TALKER_GL;
+        case 'N':
+            return NMEA_TALKER_GN;
+        case 'P':
+            return NMEA_TALKER_GP;
+        default:
+            return NMEA_TALKER_NONE;
+        }
+    default:
+        return NMEA_TALKER_NONE;
     }
-    if (valid) {
-        // Convert UTC time to local time
-        if (ct_offset.sign) {
-            if (zda0.ct.m < ct_offset.m) {
-                zda0.ct.m = zda0.ct.m + 60 - ct_offset.m;
-                ct_offset.h++;
-            } else {
-                zda0.ct.m -= ct_offset.m;
+}
+
+// Match the k-th character of the sentence type against the types from
+// ... the candidate matched so far on
+// ... return true if a type matches, false if none
+bool nmea_match_type(nmea_t* p, uint8_t k, uint8_t c) {
+    const char* t = nmea_types[p->sentence - NMEA_GGA].type;
+    const char* u = NULL;
+    uint8_t d;
+
+    for (uint8_t s = p->sentence; s < NMEA_SENTENCE_COUNT; s++) {
+        u = nmea_types[s - NMEA_GGA].type;
+        // Types past those sharing the characters matched so far
+        for (uint8_t i = 0; i < k; i++) {
+            if (pgm_read_byte(&u[i]) != pgm_read_byte(&t[i])) {
+                return false;
             }
-            if (zda0.ct.h < ct_offset.h) {
-                zda0.ct.h = zda0.ct.h + 24 - ct_offset.h;
-                ctime_decrement_day(&zda0.ct);
-            } else {
-                zda0.ct.h -= ct_offset.h;
+        }
+        d = pgm_read_byte(&u[k]);
+        if (d == c) {
+            p->sentence = s;
+            return true;
+        }
+        if (d > c) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// Match a character of the address against talkers and types recognized
+// ... return true if it may still be of a sentence handled, false if not
+bool nmea_match_address(nmea_t* p, uint8_t c) {
+    uint8_t k = p->length++;
+
+    switch (k) {
+    case 0:
+        p->text[0] = c;
+        return true;
+    case 1:
+        p->talker = nmea_talker(p->text[0], c);
+        p->sentence = NMEA_GGA;
+        return p->talker != NMEA_TALKER_NONE;
+    case 2:
+    case 3:
+        return nmea_match_type(p, k - 2, c);
+    case 4:
+        if (!nmea_match_type(p, k - 2, c)) {
+            return false;
+        }
+        memcpy_P(&p->handler, &p->handlers[p->sentence], sizeof(p->handler));
+        return p->handler.done != NULL;
+    default:
+        return false;
+    }
+}
+
+// Convert the field just ended, if asked for, by the converter of the
+// ... sentence
+// ... return true if the field is invalid, false if valid
+bool nmea_end_field(nmea_t* p) {
+    const nmea_type_t* t = &nmea_types[p->sentence - NMEA_GGA];
+    bool (*end_field)(nmea_t* p);
+
+    if (p->field >= pgm_read_byte(&t->fields_max)) {
+        return true;
+    }
+    if (!(p->handler.fields & ((uint32_t) 1 << p->field))) {
+        return false;
+    }
+    memcpy_P(&end_field, &t->end_field, sizeof(end_field));
+    return end_field(p);
+}
+
+// Feed a received byte to the parser
+// ... return the sentence when it is complete and valid, after its handler
+// ... is called with the result, NMEA_NONE otherwise
+nmea_sentence_t nmea_parse(nmea_t* p, uint8_t c) {
+    const nmea_type_t* t = NULL;
+    void (*finish)(nmea_t* p);
+
+    // Sentences start over on '$' anywhere
+    if (c == '$') {
+        p->part = NMEA_PART_ADDRESS;
+        p->talker = NMEA_TALKER_NONE;
+        p->sentence = NMEA_NONE;
+        p->valid = true;
+        p->checksum = 0x00;
+        p->length = 0;
+        return NMEA_NONE;
+    }
+    switch (p->part) {
+    case NMEA_PART_ADDRESS:
+        if (c == ',') {
+            // Types are matched to the last character
+            if (p->length != 5) {
+                p->part = NMEA_PART_NONE;
+                break;
             }
-        } else {
-            if (zda0.ct.m + ct_offset.m >= 60) {
-                zda0.ct.m = zda0.ct.m + ct_offset.m - 60;
-                ct_offset.h++;
-            } else {
-                zda0.ct.m += ct_offset.m;
+            p->part = NMEA_PART_FIELDS;
+            p->field = 0;
+            memset(&p->result, 0, sizeof(p->result));
+            nmea_clear_field(p);
+        } else if (!nmea_match_address(p, c)) {
+            // Skip sentences not recognized or not handled
+            p->part = NMEA_PART_NONE;
+            break;
+        }
+        p->checksum ^= c;
+        break;
+    case NMEA_PART_FIELDS:
+        if (c == ',' || c == '*') {
+            if (nmea_end_field(p)) {
+                p->valid = false;
             }
-            if (zda0.ct.h + ct_offset.h >= 24) {
-                zda0.ct.h = zda0.ct.h + ct_offset.h - 24;
-                ctime_increment_day(&zda0.ct);
-            } else {
-                zda0.ct.h += ct_offset.h;
+            if (c == '*') {
+                p->part = NMEA_PART_CHECKSUM;
+                p->length = 0;
+                p->checksum_given = 0x00;
+                break;
             }
+            p->field++;
+            nmea_clear_field(p);
+            p->checksum ^= c;
+        } else if (c == '\r' || c == '\n') {
+            // Sentences without checksum are not taken
+            p->part = NMEA_PART_NONE;
+        } else {
+            nmea_add_char(p, c);
+            p->checksum ^= c;
+        }
+        break;
+    case NMEA_PART_CHECKSUM:
+        if (!isxdigit(c)) {
+            p->part = NMEA_PART_NONE;
+            break;
+        }
+        p->checksum_given = p->checksum_given << 4 | c2b(c);
+        if (++p->length < 2) {
+            break;
+        }
+        p->part = NMEA_PART_NONE;
+        t = &nmea_types[p->sentence - NMEA_GGA];
+        if (!p->valid || p->checksum_given != p->checksum ||
+            p->field + 1 < pgm_read_byte(&t->fields_min)) {
+            break;
+        }
+        memcpy_P(&finish, &t->finish, sizeof(finish));
+        if (finish) {
+            finish(p);
         }
-        *zda = zda0;
+        p->handler.done(p);
+        return p->sentence;
+    default:
+        break;
     }
-    return valid == false;
+    return NMEA_NONE;
 }
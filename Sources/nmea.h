@@ -8,67 +8,290 @@
 #ifndef NMEA_H_
 #define NMEA_H_
 
+// Streaming NMEA 0183 parser;
+// ... received bytes are fed one at a time, and the checksum is taken on
+// ... the way. Sentences are told by their talker and type as the address
+// ... comes, and those without a handler given by the caller are skipped
+// ... there. Only fields asked for by the handler are converted, straight
+// ... into the result of the sentence, and the handler is called as soon
+// ... as the "*hh" checksum is validated; no line is buffered
+
+// Sentences recognized, in alphabetical order of their types
+typedef enum {
+    NMEA_NONE,
+    NMEA_GGA,
+    NMEA_GNS,
+    NMEA_GSA,
+    NMEA_RMC,
+    NMEA_ZDA,
+    NMEA_SENTENCE_COUNT
+} nmea_sentence_t;
+
+// Talkers recognized; GPS, multiple constellations, GLONASS, Galileo and
+// ... BeiDou (GB since NMEA 4.10, BD before)
+typedef enum {
+    NMEA_TALKER_NONE,
+    NMEA_TALKER_GP,
+    NMEA_TALKER_GN,
+    NMEA_TALKER_GL,
+    NMEA_TALKER_GA,
+    NMEA_TALKER_GB,
+    NMEA_TALKER_BD
+} nmea_talker_t;
+
+// Parts of a sentence
+typedef enum {
+    // Out of sentences, waiting for '$'
+    NMEA_PART_NONE,
+    NMEA_PART_ADDRESS,
+    NMEA_PART_FIELDS,
+    NMEA_PART_CHECKSUM
+} nmea_part_t;
+
+// Fields of $__GGA sentence, in order
+typedef enum {
+    GGA_TIME,
+    GGA_LATITUDE,
+    GGA_LATITUDE_DIRECTION,
+    GGA_LONGITUDE,
+    GGA_LONGITUDE_DIRECTION,
+    GGA_STATUS,
+    GGA_SATS_IN_USE,
+    GGA_HDOP,
+    GGA_HEIGHT,
+    GGA_HEIGHT_UNITS,
+    GGA_GEOID_SEPARATION,
+    GGA_GEOID_SEPARATION_UNITS,
+    GGA_DGPS_AGE,
+    GGA_DGPS_STATION_ID
+} gga_field_t;
+
+// Fields of $__GNS sentence, in order
+typedef enum {
+    GNS_TIME,
+    GNS_LATITUDE,
+    GNS_LATITUDE_DIRECTION,
+    GNS_LONGITUDE,
+    GNS_LONGITUDE_DIRECTION,
+    GNS_MODE,
+    GNS_SATS_IN_USE,
+    GNS_HDOP,
+    GNS_HEIGHT,
+    GNS_GEOID_SEPARATION,
+    GNS_DGPS_AGE,
+    GNS_DGPS_STATION_ID,
+    GNS_NAV_STATUS
+} gns_field_t;
+
+// Fields of $__GSA sentence, in order
+typedef enum {
+    GSA_SELECTION,
+    GSA_FIX,
+    GSA_SAT_FIRST,
+    GSA_SAT_LAST = GSA_SAT_FIRST + 11,
+    GSA_PDOP,
+    GSA_HDOP,
+    GSA_VDOP,
+    GSA_SYSTEM_ID
+} gsa_field_t;
+
+// Fields of $__RMC sentence, in order
+typedef enum {
+    RMC_TIME,
+    RMC_STATUS,
+    RMC_LATITUDE,
+    RMC_LATITUDE_DIRECTION,
+    RMC_LONGITUDE,
+    RMC_LONGITUDE_DIRECTION,
+    RMC_SPEED,
+    RMC_COURSE,
+    RMC_DATE,
+    RMC_VARIATION,
+    RMC_VARIATION_DIRECTION,
+    RMC_MODE,
+    RMC_NAV_STATUS
+} rmc_field_t;
+
+// Fields of $__ZDA sentence, in order
+typedef enum {
+    ZDA_TIME,
+    ZDA_DAY,
+    ZDA_MONTH,
+    ZDA_YEAR,
+    ZDA_OFFSET_HOURS,
+    ZDA_OFFSET_MINUTES
+} zda_field_t;
+
+// Unsigned decimal number
+typedef struct {
+    // Integer part
+    uint16_t integer;
+    // Fraction part, multiplied by 10000
+    uint16_t fraction;
+} nmea_decimal_t;
+
+// Latitude, longitude or magnetic variation
+typedef struct {
+    // Direction of latitude/longitude
+    // ... 'N' or 'S' for latitude, 'E' or 'W' for longitude and variation
+    uint8_t direction;
+    // Integer part
+    uint16_t integer;
+    // Fraction part, multiplied by 10000
+    uint16_t fraction;
+} nmea_coordinate_t;
+
+// Height
+typedef struct {
+    // Sign (0: positive, 1: negative)
+    bool sign;
+    // Integer part
+    uint16_t integer;
+    // Fraction part, multiplied by 10000
+    uint16_t fraction;
+    // Units of value
+    uint8_t units;
+} nmea_height_t;
+
 // Result structure gathered from $__GGA sentence
 typedef struct {
     // UTC clock time
     ctime_t ct;
-    // Latitude and longitude structures
-    struct {
-        // Direction of latitude/longitude
-        // ... 'N' or 'S' for latitude, 'E' or 'W' for longitude
-        uint8_t direction;
-        // Integer part
-        uint16_t integer;
-        // Fraction part, multiplied by 10000
-        uint16_t fraction;
-    } latitude, longitude;
+    // Latitude and longitude
+    nmea_coordinate_t latitude, longitude;
     // Position fix status
     uint8_t status;
     // Satellites in use
     uint8_t sats_in_use;
     // HDOP (Horizontal dilusion of precision)
     // Age of DGPS data in seconds
-    struct {
-        // Integer part
-        uint16_t integer;
-        // Fraction part, multiplied by 10000
-        uint16_t fraction;
-    } hdop, dgps_age;
+    nmea_decimal_t hdop, dgps_age;
     // MSL orthometric height
     // Geoid separation
-    struct {
-        // Sign (0: positive, 1: negative)
-        bool sign;
-        // Integer part
-        uint8_t integer;
-        // Fraction part, multiplied by 10000
-        uint16_t fraction;
-        // Units of value
-        uint8_t units;
-    } height, geoid_separation;
+    nmea_height_t height, geoid_separation;
     // DGPS reference station ID
     uint16_t dgps_station_id;
-    // Expected checksum value
-    uint8_t checksum_expected;
-    // Given checksum value
-    uint8_t checksum_given;
 } gga_t;
 
+// Result structure gathered from $__GNS sentence
+typedef struct {
+    // UTC clock time
+    ctime_t ct;
+    // Latitude and longitude
+    nmea_coordinate_t latitude, longitude;
+    // Mode indicators of the first 4 constellations ('\0': not given)
+    uint8_t mode[4];
+    // Position fix status told by the mode indicators, in values of
+    // ... $__GGA (0: no fix, 1: fix, 2: differential fix)
+    uint8_t status;
+    // Satellites in use
+    uint8_t sats_in_use;
+    // HDOP
+    // Age of differential data in seconds
+    nmea_decimal_t hdop, dgps_age;
+    // MSL orthometric height and geoid separation, in meters
+    nmea_height_t height, geoid_separation;
+    // Differential reference station ID
+    uint16_t dgps_station_id;
+    // Navigational status ('\0': not given)
+    uint8_t nav_status;
+} gns_t;
+
+// Result structure gathered from $__GSA sentence
+typedef struct {
+    // Selection mode ('M': manual, 'A': automatic)
+    uint8_t selection;
+    // Fix mode (1: no fix, 2: 2D, 3: 3D)
+    uint8_t fix;
+    // Satellites used in the fix, counted from the satellite ID fields
+    uint8_t sats_in_use;
+    // PDOP, HDOP and VDOP
+    nmea_decimal_t pdop, hdop, vdop;
+    // GNSS system ID (0: not given)
+    uint8_t system_id;
+} gsa_t;
+
+// Result structure gathered from $__RMC sentence
+typedef struct {
+    // Localized clock time and date
+    ctime_t ct;
+    // Status ('A': valid, 'V': warning)
+    uint8_t status;
+    // Latitude and longitude
+    nmea_coordinate_t latitude, longitude;
+    // Speed over ground in knots, and course over ground in degrees
+    nmea_decimal_t speed, course;
+    // Magnetic variation
+    nmea_coordinate_t variation;
+    // Mode indicator and navigational status ('\0': not given)
+    uint8_t mode;
+    uint8_t nav_status;
+} rmc_t;
+
 // Result structure gathered from $__ZDA sentence
 typedef struct {
     // Localized clock time
     ctime_t ct;
-    // Expected checksum value
-    uint8_t checksum_expected;
-    // Given checksum value
-    uint8_t checksum_given;
 } zda_t;
 
-bool isdigitn(uint8_t* s, uint16_t n);
-bool isxdigitn(uint8_t* s, uint16_t n);
-uint16_t consecutive_digits(uint8_t* s);
+struct nmea;
+
+// Handler of a sentence given by the caller, in program memory
+typedef struct {
+    // Fields to convert; bits of the field enumeration of the sentence
+    uint32_t fields;
+    // Called with the result when the sentence is complete and valid;
+    // ... NULL to skip the sentence
+    void (*done)(struct nmea* p);
+} nmea_handler_t;
+
+// Parser structure
+typedef struct nmea {
+    // Handlers indexed by nmea_sentence_t, in program memory
+    const nmea_handler_t* handlers;
+    // Part of the sentence being parsed (nmea_part_t)
+    uint8_t part;
+    // Talker and sentence being parsed, and its handler
+    nmea_talker_t talker;
+    nmea_sentence_t sentence;
+    nmea_handler_t handler;
+    // Whether the sentence is valid so far
+    bool valid;
+    // Checksum so far, and the one given
+    uint8_t checksum;
+    uint8_t checksum_given;
+    // Field being parsed, and characters in it up to 255
+    uint8_t field;
+    uint8_t length;
+    // First characters of the field
+    uint8_t text[4];
+    // Whether the field has a decimal point, a leading minus sign, and
+    // ... characters other than digits, hexadecimal digits or those
+    bool dot;
+    bool sign;
+    bool other;
+    bool nonhex;
+    // Digits in integer and fraction parts, up to 255
+    uint8_t digits;
+    uint8_t fraction_digits;
+    // Integer part up to 9 digits, and fraction part multiplied by 10000
+    uint32_t integer;
+    uint16_t fraction;
+    // Lower 16 bits of the value of hexadecimal digits
+    uint16_t hex;
+    // Result of the sentence; fields not converted are left zero
+    union {
+        gga_t gga;
+        gns_t gns;
+        gsa_t gsa;
+        rmc_t rmc;
+        zda_t zda;
+    } result;
+} nmea_t;
+
 uint8_t c2b(uint8_t c);
-bool parse_gga(gga_t* gga, uint8_t* s, uint16_t count);
-bool parse_zda(zda_t* zda, uint8_t* s, uint16_t count);
+void nmea_initialize(nmea_t* p, const nmea_handler_t* handlers);
+void nmea_reset(nmea_t* p);
+nmea_sentence_t nmea_parse(nmea_t* p, uint8_t c);
 
 #endif
@@ -0,0 +1,203 @@
+/*
+ * DotMatrixClock2018/profile.c
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "hal.h"
+#include "sched.h"
+#include "timebase.h"
+#include "usart.h"
+#include "profile.h"
+
+#ifdef PROFILER
+
+// Length of a dumped line
+#define PROFILE_LINE_LENGTH  112
+
+// CPU cycles per tick
+#define PROFILE_TICK_CYCLES  (F_CPU / 1000)
+
+// USART transmitter buffer
+extern ringbuf_t tx;
+
+// Summaries of entries
+profile_t profiles[PROFILE_COUNT];
+
+// Names of entries
+PROGMEM char const profile_names[PROFILE_COUNT][12] = {
+    [TASK_ADVANCE_CLOCK] = "clock",
+    [TASK_READ_KEYS] = "keys",
+    [TASK_DRAW_SCREEN] = "draw",
+    [TASK_HANDLE_RX] = "rx",
+    [TASK_CHECK_RELAY_OUTPUT] = "relay",
+    [TASK_SERIAL_OUTPUT] = "serial",
+    [TASK_SET_BRIGHTNESS] = "brightness",
+    [TASK_READ_TEMPERATURE] = "temperature",
+    [TASK_UPDATE_TEMPERATURE] = "temp_update",
+    [TASK_SAVE_CTIME_TO_RTC] = "rtc",
+    [TASK_DETECT_BAUD] = "baud",
+    [TASK_BOOT] = "boot",
+    [TASK_PROFILE_DUMP] = "profile",
+#ifdef TRACE
+    [TASK_TRACE_DRAIN] = "trace",
+#endif
+    [PROFILE_TIMER0] = "TIMER0",
+    [PROFILE_TIMER1] = "TIMER1",
+    [PROFILE_USART_RX] = "USART_RX",
+    [PROFILE_USART_UDRE] = "USART_UDRE",
+    [PROFILE_TWI] = "TWI"
+};
+
+// Dump in progress
+struct {
+    // Runs of the dump task since the last dump
+    uint16_t runs;
+    // Entry of the line being sent (PROFILE_COUNT: header, more: idle)
+    uint8_t entry;
+    // Line being sent and the position of the next character
+    char line[PROFILE_LINE_LENGTH];
+    uint8_t pos;
+} profile_dump = { 0, PROFILE_COUNT + 1 };
+
+// Get CPU cycles since startup (modulo 2^32) from the main loop
+uint32_t profile_now() {
+    uint8_t seq;
+    uint32_t t;
+    uint16_t c;
+
+    // A compare match between reading ticks and Timer1 runs the tick ISR
+    // ... before the sequence is read again, so it is retried
+    do {
+        seq = timebase_seq;
+        t = ticks;
+        c = hal_timer1_count();
+    } while (seq != timebase_seq);
+    return t * PROFILE_TICK_CYCLES + c;
+}
+
+// Get CPU cycles since Timer1 read t0 in the same ISR
+uint16_t profile_isr_cycles(uint16_t t0) {
+    uint16_t t = hal_timer1_count();
+
+    return t >= t0 ? t - t0 : t + PROFILE_TICK_CYCLES - t0;
+}
+
+// Add a run time in cycles to the summary of an entry
+void profile_record(uint8_t id, uint32_t cycles) {
+    profile_t* p = &profiles[id];
+    uint32_t limit = 64;
+    uint8_t b = 0;
+
+    if (p->count == 0 || cycles < p->min) {
+        p->min = cycles;
+    }
+    if (cycles > p->max) {
+        p->max = cycles;
+    }
+    p->count++;
+    p->sum += cycles;
+    while (b < PROFILE_BUCKETS - 1 && cycles >= limit) {
+        b++;
+        limit <<= 2;
+    }
+    if (p->hist[b] != UINT16_MAX) {
+        p->hist[b]++;
+    }
+}
+
+// Append a decimal number to a string, return its length
+uint8_t profile_format_u32(char* s, uint32_t v) {
+    char digits[10];
+    uint8_t n = 0;
+    uint8_t i = 0;
+
+    s[i++] = ' ';
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    while (n) {
+        s[i++] = digits[--n];
+    }
+    return i;
+}
+
+// Format a line of an entry, then restart its summary;
+// ... return the length of the line
+uint8_t profile_format(char* s, uint8_t id) {
+    profile_t p;
+    uint8_t i = 0;
+    char c;
+
+    // Take and restart the summary at once; ISRs may be updating it
+    hal_disable_interrupts();
+    p = profiles[id];
+    profiles[id] = (profile_t) { 0 };
+    hal_enable_interrupts();
+    // "P name count min avg max hist..."
+    s[i++] = 'P';
+    s[i++] = ' ';
+    for (uint8_t j = 0; j < 12 &&
+        (c = pgm_read_byte(&profile_names[id][j])) != '\0'; j++) {
+        s[i++] = c;
+    }
+    i += profile_format_u32(&s[i], p.count);
+    i += profile_format_u32(&s[i], p.min);
+    i += profile_format_u32(&s[i], p.count ? p.sum / p.count : 0);
+    i += profile_format_u32(&s[i], p.max);
+    for (uint8_t b = 0; b < PROFILE_BUCKETS; b++) {
+        i += profile_format_u32(&s[i], p.hist[b]);
+    }
+    s[i++] = '\r';
+    s[i++] = '\n';
+    s[i] = '\0';
+    return i;
+}
+
+// T5: Dump summaries over USART every PROFILE_DUMP_RUNS runs;
+// ... lines are sent in pieces as the transmitter buffer has room
+void task5_profile_dump() {
+    bool sent = false;
+
+    if (++profile_dump.runs >= PROFILE_DUMP_RUNS &&
+        profile_dump.entry > PROFILE_COUNT) {
+        profile_dump.runs = 0;
+        profile_dump.entry = PROFILE_COUNT;
+        strcpy_P(profile_dump.line, PSTR("P name count min avg max "
+            "<64 <256 <1k <4k <16k <64k <256k more\r\n"));
+        profile_dump.pos = 0;
+    }
+    while (profile_dump.entry <= PROFILE_COUNT) {
+        while (profile_dump.line[profile_dump.pos] != '\0') {
+            if (ringbuf_put(&tx, profile_dump.line[profile_dump.pos])) {
+                break;
+            }
+            profile_dump.pos++;
+            sent = true;
+        }
+        if (profile_dump.line[profile_dump.pos] != '\0') {
+            // Transmitter buffer is full; continue on the next run
+            break;
+        }
+        // Next entry after the header is the first one
+        profile_dump.entry = profile_dump.entry == PROFILE_COUNT ?
+            0 : profile_dump.entry + 1;
+        if (profile_dump.entry < PROFILE_COUNT) {
+            profile_format(profile_dump.line, profile_dump.entry);
+            profile_dump.pos = 0;
+        } else {
+            profile_dump.entry = PROFILE_COUNT + 1;
+        }
+    }
+    if (sent) {
+        hal_usart_start_tx();
+    }
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * DotMatrixClock2018/profile.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+// Cycle profiler of tasks and ISRs;
+// ... with PROFILER defined, run time of every task and ISR is timed in CPU
+// ... cycles by Timer1 and ticks, and summarized in count, min/avg/max and
+// ... a histogram. TASK_PROFILE_DUMP sends the summaries over USART every
+// ... PROFILE_DUMP_RUNS runs and restarts them. Without PROFILER all of
+// ... this compiles to nothing
+
+// Entries profiled; tasks by their IDs, followed by ISRs
+enum {
+    PROFILE_TIMER0 = TASK_COUNT,
+    PROFILE_TIMER1,
+    PROFILE_USART_RX,
+    PROFILE_USART_UDRE,
+    PROFILE_TWI,
+    PROFILE_COUNT
+};
+
+#ifdef PROFILER
+
+// Interval of TASK_PROFILE_DUMP, and its runs per dump (30 seconds)
+#define PROFILE_TASK_INTERVAL_MS    20
+#define PROFILE_DUMP_RUNS         1500
+
+// Histogram buckets; the first one is for less than 64 cycles, and each
+// ... next one for 4 times as many, the last one for all the rest
+#define PROFILE_BUCKETS              8
+
+// Summary of run time in cycles
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint16_t hist[PROFILE_BUCKETS];
+} profile_t;
+
+extern profile_t profiles[PROFILE_COUNT];
+
+// Start and end timing a task in the main loop
+#define profile_begin()  profile_now()
+#define profile_end(id, t0)  profile_record((id), profile_now() - (t0))
+// Start and end timing an ISR; ISRs are shorter than a tick
+#define profile_isr_begin()  hal_timer1_count()
+#define profile_isr_end(id, t0) \
+    profile_record((id), profile_isr_cycles(t0))
+
+uint32_t profile_now();
+uint16_t profile_isr_cycles(uint16_t t0);
+void profile_record(uint8_t id, uint32_t cycles);
+uint8_t profile_format(char* s, uint8_t id);
+void task5_profile_dump();
+
+#else
+
+#define profile_begin()  0
+#define profile_end(id, t0)  ((void) (t0))
+#define profile_isr_begin()  0
+#define profile_isr_end(id, t0)  ((void) (t0))
+
+#endif
+
+#endif
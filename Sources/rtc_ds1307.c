@@ -6,11 +6,19 @@
  */
 
 #include <stdint.h>
-#include <util/twi.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include "twi.h"
 #include "ctime.h"
 #include "rtc_ds1307.h"
 
+// Transactions and their data; register pointer followed by registers
+twi_xfer_t rtc_write_xfer = { .addr7 = ADDR7_DS1307, .status = TWI_OK };
+twi_xfer_t rtc_read_xfer = { .addr7 = ADDR7_DS1307, .status = TWI_OK };
+uint8_t rtc_write_data[9];
+uint8_t rtc_read_pointer = REG_DS1307_SECONDS;
+uint8_t rtc_read_data[7];
+
 // Convert a BCD value to binary
 inline uint8_t bcd_to_binary(uint8_t n) {
     return 10 * (n >> 4) + (n & 0x0f);
@@ -21,55 +29,68 @@ inline uint8_t binary_to_bcd(uint8_t n) {
     return ((n / 10 % 10) << 4) | (n % 10);
 }
 
+// Start writing clock time to RTC in the background
+// ... return 0 if started, 1 if the last write is still running
+uint8_t rtc_ds1307_start_write(ctime_t* ct, dow_t dow) {
+    uint8_t* data = rtc_write_data;
+
+    if (rtc_write_xfer.status == TWI_BUSY) {
+        return 1;
+    }
+    // Pack data to write
+    data[0] = REG_DS1307_SECONDS;
+    data[1] = (0 << 7) | (binary_to_bcd(ct->s) & 0x7f);
+    data[2] = binary_to_bcd(ct->m) & 0x7f;
+    data[3] = (0 << 6) | (binary_to_bcd(ct->h) & 0x3f);
+    data[4] = (uint8_t) dow & 0x07;
+    data[5] = binary_to_bcd(ct->d) & 0x3f;
+    data[6] = binary_to_bcd(ct->mo) & 0x1f;
+    data[7] = (ct->yh << 4) | ct->yl;
+    data[8] = (1 << 4) | (0 << 1) | (0 << 0);  // SQW enabled, 1 Hz
+    rtc_write_xfer.tx = data;
+    rtc_write_xfer.tx_length = sizeof(rtc_write_data);
+    rtc_write_xfer.rx_length = 0;
+    rtc_write_xfer.done = NULL;
+    twi_submit(&rtc_write_xfer);
+    return 0;
+}
+
 // Write clock time to RTC
 // ... return 0 if no error, 1 if error in communication
 uint8_t rtc_ds1307_write_clock(ctime_t* ct, dow_t dow) {
-    uint8_t data[8];
+    // Wait for the last write, if any, not to skip this one
+    twi_wait(&rtc_write_xfer);
+    rtc_ds1307_start_write(ct, dow);
+    return twi_wait(&rtc_write_xfer);
+}
 
-    // Pack data to write
-    data[0] = (0 << 7) | (binary_to_bcd(ct->s) & 0x7f);
-    data[1] = binary_to_bcd(ct->m) & 0x7f;
-    data[2] = (0 << 6) | (binary_to_bcd(ct->h) & 0x3f);
-    data[3] = (uint8_t) dow & 0x07;
-    data[4] = binary_to_bcd(ct->d) & 0x3f;
-    data[5] = binary_to_bcd(ct->mo) & 0x1f;
-    data[6] = (ct->yh << 4) | ct->yl;
-    data[7] = (1 << 4) | (0 << 1) | (0 << 0);  // SQW enabled, 1 Hz
-    // Start communication
-    if (twi_start_condition()) goto error;
-    if (twi_master_address(ADDRW_DS1307)) goto error;
-    if (twi_master_transmit(REG_DS1307_SECONDS))
-        goto error;
-    for (uint8_t i = 0; i < 8; i++) {
-        if (twi_master_transmit(data[i])) goto error;
+// Start reading clock time from RTC in the background; the callback is
+// ... called by the TWI ISR on completion, then the time is taken by
+// ... rtc_ds1307_finish_read()
+// ... return 0 if started, 1 if the last read is still running
+uint8_t rtc_ds1307_start_read(void (*done)(twi_xfer_t* x)) {
+    if (rtc_read_xfer.status == TWI_BUSY) {
+        return 1;
     }
-    twi_stop_condition();
+    rtc_read_xfer.tx = &rtc_read_pointer;
+    rtc_read_xfer.tx_length = 1;
+    rtc_read_xfer.rx = rtc_read_data;
+    rtc_read_xfer.rx_length = sizeof(rtc_read_data);
+    rtc_read_xfer.done = done;
+    twi_submit(&rtc_read_xfer);
     return 0;
-
-error:
-    twi_stop_condition();
-    return 1;
 }
 
-// Read clock time from RTC
-// ... return 0 if no error, 1 if error in communication
-uint8_t rtc_ds1307_read_clock(ctime_t* ct, dow_t* dow) {
-    uint8_t data[7];
+// Take clock time read from RTC
+// ... return 0 if no error, 1 if error in communication or still running
+uint8_t rtc_ds1307_finish_read(ctime_t* ct, dow_t* dow) {
+    uint8_t* data = rtc_read_data;
     ctime_t ct0;
     dow_t dow0;
 
-    // Start communication
-    if (twi_start_condition()) goto error;
-    if (twi_master_address(ADDRW_DS1307)) goto error;
-    if (twi_master_transmit(REG_DS1307_SECONDS))
-        goto error;
-    if (twi_start_condition()) goto error;
-    if (twi_master_address(ADDRR_DS1307)) goto error;
-    for (uint8_t i = 0; i < 6; i++) {
-        if (twi_master_receive(&data[i], TWI_ACK)) goto error;
+    if (rtc_read_xfer.status != TWI_OK) {
+        return 1;
     }
-    if (twi_master_receive(&data[6], TWI_NACK)) goto error;
-    twi_stop_condition();
     // Unpack data
     ct0.ms = 500;
     ct0.s = bcd_to_binary(data[0] & 0x7f);
@@ -94,8 +115,13 @@ uint8_t rtc_ds1307_read_clock(ctime_t* ct, dow_t* dow) {
     *ct = ct0;
     *dow = dow0;
     return 0;
+}
 
-error:
-    twi_stop_condition();
-    return 1;
+// Read clock time from RTC
+// ... return 0 if no error, 1 if error in communication
+uint8_t rtc_ds1307_read_clock(ctime_t* ct, dow_t* dow) {
+    twi_wait(&rtc_read_xfer);
+    rtc_ds1307_start_read(NULL);
+    twi_wait(&rtc_read_xfer);
+    return rtc_ds1307_finish_read(ct, dow);
 }
@@ -26,7 +26,10 @@ enum {
     REG_DS1307_SRAM      = 0x08
 };
 
+uint8_t rtc_ds1307_start_write(ctime_t* ct, dow_t dow);
 uint8_t rtc_ds1307_write_clock(ctime_t* ct, dow_t dow);
+uint8_t rtc_ds1307_start_read(void (*done)(twi_xfer_t* x));
+uint8_t rtc_ds1307_finish_read(ctime_t* ct, dow_t* dow);
 uint8_t rtc_ds1307_read_clock(ctime_t* ct, dow_t* dow);
 
 #endif
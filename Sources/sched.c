@@ -0,0 +1,191 @@
+/*
+ * DotMatrixClock2018/sched.c
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "hal.h"
+#include "bench.h"
+#include "sched.h"
+#include "timebase.h"
+#include "profile.h"
+#include "trace.h"
+
+// Tasks indexed by their IDs
+task_t tasks[TASK_COUNT];
+
+// IDs of periodic tasks in order of their deadlines
+uint8_t sched_queue[TASK_COUNT];
+uint8_t sched_queue_count = 0;
+
+// Whether the main loop is sleeping, and load sampled by the tick ISR
+volatile bool sched_idling = false;
+volatile load_t sched_load;
+
+// Add a periodic task; it gets ready first after an interval
+void sched_add_periodic(task_id_t id, void (*run)(void), uint16_t interval) {
+    tasks[id].run = run;
+    tasks[id].interval = interval;
+    tasks[id].ready = timebase_ticks16() + interval;
+    tasks[id].pending = 0;
+    sched_enqueue(id);
+}
+
+// Add an event task; it gets ready when posted
+void sched_add_event(task_id_t id, void (*run)(void)) {
+    tasks[id].run = run;
+    tasks[id].interval = 0;
+    tasks[id].pending = 0;
+}
+
+// Insert a periodic task into the queue by its deadline;
+// ... tasks of the same deadline are in order of priority
+void sched_enqueue(uint8_t id) {
+    uint8_t i = sched_queue_count++;
+    int16_t d;
+
+    while (i > 0) {
+        d = (int16_t) (tasks[id].ready - tasks[sched_queue[i - 1]].ready);
+        if (d > 0 || (d == 0 && id > sched_queue[i - 1])) {
+            break;
+        }
+        sched_queue[i] = sched_queue[i - 1];
+        i--;
+    }
+    sched_queue[i] = id;
+}
+
+// Remove a periodic task from the queue
+void sched_dequeue(uint8_t id) {
+    uint8_t i = 0;
+
+    while (i < sched_queue_count && sched_queue[i] != id) {
+        i++;
+    }
+    if (i == sched_queue_count) {
+        return;
+    }
+    sched_queue_count--;
+    for (; i < sched_queue_count; i++) {
+        sched_queue[i] = sched_queue[i + 1];
+    }
+}
+
+// Post an event task with interrupts disabled (from ISRs);
+// ... posts are counted up to 255, not merged
+void sched_post_isr(task_id_t id) {
+    task_t* t = &tasks[id];
+
+    if (t->pending == 0) {
+        t->ready = (uint16_t) ticks;
+    }
+    if (t->pending != UINT8_MAX) {
+        t->pending++;
+    }
+}
+
+// Post an event task from the main loop
+void sched_post(task_id_t id) {
+    hal_disable_interrupts();
+    sched_post_isr(id);
+    hal_enable_interrupts();
+}
+
+// Cancel posts not yet run with interrupts disabled
+void sched_cancel_isr(task_id_t id) {
+    tasks[id].pending = 0;
+}
+
+// Find the ready task of the highest priority
+// ... return its ID, or TASK_COUNT if none is ready
+static uint8_t sched_select(uint16_t now) {
+    uint8_t best = TASK_COUNT;
+    uint8_t id;
+
+    // Periodic tasks due, up to the first one not due
+    for (uint8_t i = 0; i < sched_queue_count; i++) {
+        id = sched_queue[i];
+        if (!timebase_reached(now, tasks[id].ready)) {
+            break;
+        }
+        if (id < best) {
+            best = id;
+        }
+    }
+    // Event tasks posted, of higher priority than above
+    for (id = 0; id < best; id++) {
+        if (tasks[id].pending) {
+            best = id;
+            break;
+        }
+    }
+    return best;
+}
+
+// Run the ready task of the highest priority
+// ... return true if any task has run, false if none is ready
+bool sched_dispatch() {
+    uint16_t now = timebase_ticks16();
+    uint8_t best = sched_select(now);
+    int16_t latency;
+    uint32_t t0;
+    task_t* t = NULL;
+
+    if (best == TASK_COUNT) {
+        return false;
+    }
+    t = &tasks[best];
+    if (t->interval) {
+        latency = (int16_t) (now - t->ready);
+        // Keep the phase of deadlines unless a whole interval is missed
+        t->ready += t->interval;
+        if (timebase_reached(now, t->ready)) {
+            t->ready = now + t->interval;
+        }
+        sched_dequeue(best);
+        sched_enqueue(best);
+    } else {
+        hal_disable_interrupts();
+        latency = (int16_t) (now - t->ready);
+        if (--t->pending) {
+            // Following posts are regarded as ready since now
+            t->ready = now;
+        }
+        hal_enable_interrupts();
+    }
+    // Posts after reading ticks above make a negative latency
+    if (latency < 0) {
+        latency = 0;
+    }
+    if (latency > t->latency_max) {
+        t->latency_max = latency;
+    }
+    t->runs++;
+    bench_task(best, latency > UINT8_MAX ? UINT8_MAX : latency);
+    trace_task(TRACE_TASK_BEGIN, best);
+    t0 = profile_begin();
+    t->run();
+    profile_end(best, t0);
+    trace_task(TRACE_TASK_END, best);
+    bench_task_end();
+    return true;
+}
+
+// Sleep until the next interrupt unless a task has got ready since the
+// ... last dispatch; without checking again with interrupts disabled, a
+// ... post just before sleeping would wait for another interrupt, up to
+// ... a bit plane of the display (537.6 us) or a tick (1 ms) later
+void sched_idle() {
+    hal_disable_interrupts();
+    if (sched_select(timebase_ticks16()) != TASK_COUNT) {
+        hal_enable_interrupts();
+        return;
+    }
+    sched_idling = true;
+    hal_idle();
+    sched_idling = false;
+}
@@ -0,0 +1,79 @@
+/*
+ * DotMatrixClock2018/sched.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+// Cooperative scheduler;
+// ... periodic tasks are kept in a queue ordered by their deadlines and
+// ... event tasks run once per post, either from ISRs or from other tasks.
+// ... Of all tasks ready, the one of the lowest ID runs first and runs to
+// ... completion; one task is dispatched per main loop pass
+
+// Task IDs in order of priority; user interface first, slow I/O last
+typedef enum {
+    TASK_ADVANCE_CLOCK,
+    TASK_READ_KEYS,
+    TASK_DRAW_SCREEN,
+    TASK_HANDLE_RX,
+    TASK_CHECK_RELAY_OUTPUT,
+    TASK_SERIAL_OUTPUT,
+    TASK_SET_BRIGHTNESS,
+    TASK_READ_TEMPERATURE,
+    TASK_UPDATE_TEMPERATURE,
+    TASK_SAVE_CTIME_TO_RTC,
+    TASK_DETECT_BAUD,
+    TASK_BOOT,
+#ifdef PROFILER
+    TASK_PROFILE_DUMP,
+#endif
+#ifdef TRACE
+    TASK_TRACE_DRAIN,
+#endif
+    TASK_COUNT
+} task_id_t;
+
+// Task
+typedef struct {
+    // Task function
+    void (*run)(void);
+    // Interval in ticks for periodic tasks, 0 for event tasks
+    uint16_t interval;
+    // Lower 16 bits of ticks when the task gets ready; the next deadline
+    // ... for periodic tasks, or the first post not yet run for event tasks
+    uint16_t ready;
+    // Posts not yet run (event tasks)
+    volatile uint8_t pending;
+    // Run count
+    uint32_t runs;
+    // Worst-case latency in ticks from getting ready to running;
+    // ... latencies over 32767 ticks are not told from negative ones
+    uint16_t latency_max;
+} task_t;
+
+// Main loop load, sampled on every tick
+typedef struct {
+    // Ticks while sleeping in sched_idle() and otherwise
+    uint32_t idle;
+    uint32_t busy;
+} load_t;
+
+extern task_t tasks[TASK_COUNT];
+extern volatile bool sched_idling;
+extern volatile load_t sched_load;
+
+void sched_add_periodic(task_id_t id, void (*run)(void), uint16_t interval);
+void sched_add_event(task_id_t id, void (*run)(void));
+void sched_enqueue(uint8_t id);
+void sched_dequeue(uint8_t id);
+void sched_post_isr(task_id_t id);
+void sched_post(task_id_t id);
+void sched_cancel_isr(task_id_t id);
+bool sched_dispatch();
+void sched_idle();
+
+#endif
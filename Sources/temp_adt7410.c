@@ -7,46 +7,54 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <util/twi.h>
+#include <stdlib.h>
 #include "twi.h"
 #include "temp_adt7410.h"
 
+// Transaction of reading temperature and its data
+twi_xfer_t adt7410_read_xfer = { .addr7 = ADDR7_ADT7410, .status = TWI_OK };
+uint8_t adt7410_read_pointer = REG_ADT7410_VALUE_MSB;
+uint8_t adt7410_read_data[2];
+
 // Send configuration to ADT7410
 // ... return 0 if no error, 1 if error in communication
 uint8_t temp_adt7410_set_config(uint8_t config) {
-    // Start communication
-    if (twi_start_condition()) goto error;
-    if (twi_master_address(ADDRW_ADT7410)) goto error;
-    if (twi_master_transmit(REG_ADT7410_CONFIG))
-        goto error;
-    twi_master_transmit(config);
-    twi_stop_condition();
-    return 0;
+    uint8_t data[2] = { REG_ADT7410_CONFIG, config };
+    twi_xfer_t x = { .addr7 = ADDR7_ADT7410, .tx = data, .tx_length = 2 };
 
-error:
-    twi_stop_condition();
-    return 1;
+    return twi_transfer(&x);
 }
 
-// Read temperature sensor value
-// ... return 0 if no error, 1 if error in communication
-uint8_t temp_adt7410_read_temperature(temp_adt7410_t* value, uint8_t* flags,
+// Start reading temperature sensor value in the background; the callback
+// ... is called by the TWI ISR on completion, then the value is taken by
+// ... temp_adt7410_finish_read()
+// ... return 0 if started, 1 if the last read is still running
+uint8_t temp_adt7410_start_read(void (*done)(twi_xfer_t* x)) {
+    if (adt7410_read_xfer.status == TWI_BUSY) {
+        return 1;
+    }
+    adt7410_read_xfer.tx = &adt7410_read_pointer;
+    adt7410_read_xfer.tx_length = 1;
+    adt7410_read_xfer.rx = adt7410_read_data;
+    adt7410_read_xfer.rx_length = sizeof(adt7410_read_data);
+    adt7410_read_xfer.done = done;
+    twi_submit(&adt7410_read_xfer);
+    return 0;
+}
+
+// Take temperature sensor value read
+// ... return 0 if no error, 1 if error in communication or still running
+uint8_t temp_adt7410_finish_read(temp_adt7410_t* value, uint8_t* flags,
     config_ad7410resol_t resol) {
-    uint8_t datah, datal;
+    uint8_t datah = adt7410_read_data[0];
+    uint8_t datal = adt7410_read_data[1];
     uint32_t temp_x10k = 0;
     uint8_t flags0 = 0x00;
     temp_adt7410_t value0;
 
-    // Start communication
-    if (twi_start_condition()) goto error;
-    if (twi_master_address(ADDRW_ADT7410)) goto error;
-    if (twi_master_transmit(REG_ADT7410_VALUE_MSB))
-        goto error;
-    if (twi_start_condition()) goto error;
-    if (twi_master_address(ADDRR_ADT7410)) goto error;
-    if (twi_master_receive(&datah, TWI_ACK)) goto error;
-    if (twi_master_receive(&datal, TWI_NACK)) goto error;
-    twi_stop_condition();
+    if (adt7410_read_xfer.status != TWI_OK) {
+        return 1;
+    }
     // Unpack data
     if (resol == CONFIG_ADT7410_RESOL_13BITS) {
         flags0 = datal & 0x07;
@@ -65,8 +73,14 @@ uint8_t temp_adt7410_read_temperature(temp_adt7410_t* value, uint8_t* flags,
     *value = value0;
     *flags = flags0;
     return 0;
+}
 
-error:
-    twi_stop_condition();
-    return 1;
+// Read temperature sensor value
+// ... return 0 if no error, 1 if error in communication
+uint8_t temp_adt7410_read_temperature(temp_adt7410_t* value, uint8_t* flags,
+    config_ad7410resol_t resol) {
+    twi_wait(&adt7410_read_xfer);
+    temp_adt7410_start_read(NULL);
+    twi_wait(&adt7410_read_xfer);
+    return temp_adt7410_finish_read(value, flags, resol);
 }
@@ -67,6 +67,9 @@ typedef struct {
 } temp_adt7410_t;
 
 uint8_t temp_adt7410_set_config(uint8_t config);
+uint8_t temp_adt7410_start_read(void (*done)(twi_xfer_t* x));
+uint8_t temp_adt7410_finish_read(temp_adt7410_t* value, uint8_t* flags,
+    config_ad7410resol_t resol);
 uint8_t temp_adt7410_read_temperature(temp_adt7410_t* value, uint8_t* flags,
     config_ad7410resol_t resol);
 
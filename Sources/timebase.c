@@ -0,0 +1,37 @@
+/*
+ * DotMatrixClock2018/timebase.c
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#include <stdint.h>
+#include "timebase.h"
+
+volatile uint32_t ticks = 0;
+volatile uint16_t clock_ms = 0;
+volatile uint8_t timebase_seq = 0;
+
+// Get ticks from the main loop
+uint32_t timebase_ticks() {
+    uint8_t seq;
+    uint32_t t;
+
+    do {
+        seq = timebase_seq;
+        t = ticks;
+    } while (seq != timebase_seq);
+    return t;
+}
+
+// Get lower 16 bits of ticks from the main loop, for deadlines
+uint16_t timebase_ticks16() {
+    uint8_t seq;
+    uint16_t t;
+
+    do {
+        seq = timebase_seq;
+        t = ticks;
+    } while (seq != timebase_seq);
+    return t;
+}
@@ -0,0 +1,36 @@
+/*
+ * DotMatrixClock2018/timebase.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+// Time base shared with ISRs;
+// ... ISRs writing the state below increment timebase_seq once after their
+// ... writes. ISRs do not nest, so a copy taken in the main loop is
+// ... consistent if the sequence is the same before and after taking it,
+// ... and is taken again otherwise; interrupts are never disabled. The
+// ... receiver error counts and the ticks of last reception in main.c are
+// ... shared by the same sequence
+
+// Elapsed time from startup in milliseconds
+extern volatile uint32_t ticks;
+// Milliseconds in the current second of clock time; seconds are carried
+// ... to clock time by posts of TASK_ADVANCE_CLOCK
+extern volatile uint16_t clock_ms;
+// Sequence of writes by ISRs
+extern volatile uint8_t timebase_seq;
+
+// Whether 16-bit ticks now have reached the deadline;
+// ... deltas are modular, so it holds over the wrap of ticks as long as
+// ... the deadline is within 32767 ms from now
+#define timebase_reached(now, deadline) \
+    ((int16_t) ((uint16_t) (now) - (uint16_t) (deadline)) >= 0)
+
+uint32_t timebase_ticks();
+uint16_t timebase_ticks16();
+
+#endif
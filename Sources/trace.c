@@ -0,0 +1,158 @@
+/*
+ * DotMatrixClock2018/trace.c
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "hal.h"
+#include "sched.h"
+#include "timebase.h"
+#include "usart.h"
+#include "trace.h"
+
+#ifdef TRACE
+
+// Records per line sent; a line fits in the transmitter buffer
+#define TRACE_LINE_RECORDS  2
+
+// USART transmitter buffer
+extern ringbuf_t tx;
+
+// Ring of records; indices run freely and wrap at the ring length
+trace_record_t trace_ring[TRACE_LENGTH];
+volatile uint8_t trace_wp = 0;
+volatile uint8_t trace_rp = 0;
+// Events lost since the last record
+uint8_t trace_lost = 0;
+// Records to go until the ring is frozen after a trigger (0: not
+// ... triggered), and whether it is frozen until sent
+uint8_t trace_countdown = 0;
+volatile bool trace_frozen = false;
+
+// Store a record with interrupts disabled
+// ... return true on success, false if the ring is full
+bool trace_put(uint8_t event, uint8_t arg) {
+    trace_record_t* r = NULL;
+
+    if ((uint8_t) (trace_wp - trace_rp) >= TRACE_LENGTH) {
+        return false;
+    }
+    r = &trace_ring[trace_wp & (TRACE_LENGTH - 1)];
+    r->event = event;
+    r->arg = arg;
+    r->ms = (uint16_t) ticks;
+    r->cycles = hal_timer1_count();
+    trace_wp++;
+    return true;
+}
+
+// Record an event with interrupts disabled (from ISRs);
+// ... the tick ISR pending makes the time 1 ms behind, which the decoder
+// ... corrects by the order of records
+void trace_record_isr(uint8_t event, uint8_t arg) {
+#if TRACE_TRIGGER
+    if (trace_frozen) {
+        return;
+    }
+    // Drop the oldest record to keep the latest ones
+    if ((uint8_t) (trace_wp - trace_rp) >= TRACE_LENGTH) {
+        trace_rp++;
+    }
+    trace_put(event, arg);
+    if (trace_countdown) {
+        if (--trace_countdown == 0) {
+            trace_frozen = true;
+        }
+    } else if (TRACE_TRIGGER & (1u << event)) {
+        trace_countdown = TRACE_LENGTH / 2;
+    }
+#else
+    if (trace_lost) {
+        if (!trace_put(TRACE_LOST, trace_lost)) {
+            if (trace_lost != UINT8_MAX) {
+                trace_lost++;
+            }
+            return;
+        }
+        trace_lost = 0;
+    }
+    if (!trace_put(event, arg)) {
+        trace_lost = 1;
+    }
+#endif
+}
+
+// Record an event from the main loop
+void trace_record(uint8_t event, uint8_t arg) {
+    hal_disable_interrupts();
+    trace_record_isr(event, arg);
+    hal_enable_interrupts();
+}
+
+// Append a byte to a line in 2 hexadecimal digits
+char* trace_format_hex(char* s, uint8_t b) {
+    uint8_t d;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        d = i == 0 ? b >> 4 : b & 0x0f;
+        *s++ = d < 10 ? '0' + d : 'A' - 10 + d;
+    }
+    return s;
+}
+
+// T5: Send records over USART while the transmitter is idle;
+// ... lines are written at once, so they are never mixed with other
+// ... messages. "T" is followed by records in hexadecimal, each of event,
+// ... argument, milliseconds and Timer1 count, from the oldest
+void task5_trace_drain() {
+    char line[1 + TRACE_LINE_RECORDS * 12 + 2];
+    char* s = line;
+    trace_record_t r;
+    uint8_t n = 0;
+
+#if TRACE_TRIGGER
+    if (!trace_frozen) {
+        return;
+    }
+#endif
+    if (ringbuf_available(&tx)) {
+        return;
+    }
+    *s++ = 'T';
+    while (n < TRACE_LINE_RECORDS) {
+        hal_disable_interrupts();
+        if (trace_rp == trace_wp) {
+            hal_enable_interrupts();
+            break;
+        }
+        r = trace_ring[trace_rp & (TRACE_LENGTH - 1)];
+        trace_rp++;
+        hal_enable_interrupts();
+        s = trace_format_hex(s, r.event);
+        s = trace_format_hex(s, r.arg);
+        s = trace_format_hex(s, r.ms >> 8);
+        s = trace_format_hex(s, r.ms & 0xff);
+        s = trace_format_hex(s, r.cycles >> 8);
+        s = trace_format_hex(s, r.cycles & 0xff);
+        n++;
+    }
+    if (n == 0) {
+#if TRACE_TRIGGER
+        // Sent all; record again until the next trigger
+        trace_frozen = false;
+#endif
+        return;
+    }
+    *s++ = '\r';
+    *s++ = '\n';
+    for (char* p = line; p < s; p++) {
+        ringbuf_put(&tx, *p);
+    }
+    hal_usart_start_tx();
+}
+
+#endif
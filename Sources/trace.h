@@ -0,0 +1,116 @@
+/*
+ * DotMatrixClock2018/trace.h
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+// Event trace;
+// ... with TRACE defined, events of the kinds in TRACE_MASK are recorded
+// ... with their time into a ring in SRAM, and TASK_TRACE_DRAIN sends them
+// ... over USART while the transmitter is idle, as "T" lines decoded by
+// ... Tools/trace/tracedec.py. With TRACE_TRIGGER set to a mask of event
+// ... kinds, the ring keeps the latest events instead, and is frozen and
+// ... sent half a ring after one of those kinds. Without TRACE all of this
+// ... compiles to nothing
+
+// Event kinds and their arguments
+typedef enum {
+    // Events not recorded as the ring was full; count up to 255
+    TRACE_LOST,
+    // Task started and finished running; task ID
+    TRACE_TASK_BEGIN,
+    TRACE_TASK_END,
+    // ISR entered; scan line, 0, byte received, byte sent or 0 if none
+    TRACE_TIMER0,
+    TRACE_TIMER1,
+    TRACE_USART_RX,
+    TRACE_USART_UDRE,
+    // Screen state changed by keys; new state
+    TRACE_STATE,
+    // TWI slave addressed and stop condition; address with R/W bit, 0
+    TRACE_TWI_START,
+    TRACE_TWI_STOP,
+    // Buffer overflowed; trace_buffer_t
+    TRACE_OVERFLOW
+} trace_event_t;
+
+// Buffers told by TRACE_OVERFLOW
+typedef enum {
+    TRACE_BUFFER_RX,
+    TRACE_BUFFER_USART
+} trace_buffer_t;
+
+#ifdef TRACE
+
+// Kinds of events recorded; ISRs firing thousands of times a second and
+// ... USART bytes, including those of trace lines, are left out by default
+#ifndef TRACE_MASK
+#define TRACE_MASK  ((1u << TRACE_LOST) | (1u << TRACE_TASK_BEGIN) | \
+    (1u << TRACE_TASK_END) | (1u << TRACE_STATE) | \
+    (1u << TRACE_TWI_START) | (1u << TRACE_TWI_STOP) | \
+    (1u << TRACE_OVERFLOW))
+#endif
+// Tasks recorded by TRACE_TASK_BEGIN and TRACE_TASK_END; tasks running
+// ... every 20 ms or on every byte received are left out by default, as
+// ... USART at 9600 bps carries about 70 records a second
+#ifndef TRACE_TASKS
+#define TRACE_TASKS  (~((1u << TASK_READ_KEYS) | (1u << TASK_DRAW_SCREEN) | \
+    (1u << TASK_HANDLE_RX) | (1u << TASK_TRACE_DRAIN)))
+#endif
+// Kinds of events freezing the ring; 0 to send events as they come
+#ifndef TRACE_TRIGGER
+#define TRACE_TRIGGER  0
+#endif
+
+// Ring length in records; a power of 2 up to 128
+#define TRACE_LENGTH                32
+// Interval of TASK_TRACE_DRAIN
+#define TRACE_TASK_INTERVAL_MS      10
+
+// Record of an event
+typedef struct {
+    uint8_t event;
+    uint8_t arg;
+    // Lower 16 bits of ticks and Timer1 count in the tick
+    uint16_t ms;
+    uint16_t cycles;
+} trace_record_t;
+
+// Record an event of a constant kind from ISRs or from the main loop
+#define trace_event_isr(event, arg) \
+    do { \
+        if (TRACE_MASK & (1u << (event))) { \
+            trace_record_isr((event), (arg)); \
+        } \
+    } while (0)
+#define trace_event(event, arg) \
+    do { \
+        if (TRACE_MASK & (1u << (event))) { \
+            trace_record((event), (arg)); \
+        } \
+    } while (0)
+// Record an event of a task in TRACE_TASKS
+#define trace_task(event, id) \
+    do { \
+        if (TRACE_TASKS & (1u << (id))) { \
+            trace_event((event), (id)); \
+        } \
+    } while (0)
+
+void trace_record_isr(uint8_t event, uint8_t arg);
+void trace_record(uint8_t event, uint8_t arg);
+void task5_trace_drain();
+
+#else
+
+#define trace_event_isr(event, arg)
+#define trace_event(event, arg)
+#define trace_task(event, id)
+
+#endif
+
+#endif
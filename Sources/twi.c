@@ -5,113 +5,148 @@
  *  Target: ATmega328P
  */
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <avr/io.h>
 #include <util/twi.h>
+#include "hal.h"
+#include "sched.h"
 #include "twi.h"
+#include "profile.h"
+#include "trace.h"
 
-// Wait for TWI interrupt flag is set
-inline void twi_wait_for_flag() {
-    while (!(TWCR & (1 << TWINT)));
-}
+// Control values; the interrupt is enabled while a transaction runs
+#define TWCR_START     ((1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE))
+#define TWCR_CONTINUE  ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+#define TWCR_STOP      ((1 << TWINT) | (1 << TWSTO) | (1 << TWEN))
 
-// Generate start condition, return 0 if successful
-uint8_t twi_start_condition() {
-    uint8_t result = 0;
+// Queue of transactions; the first one is running
+twi_xfer_t* twi_head = NULL;
+twi_xfer_t* twi_tail = NULL;
+// Whether a callback is running; the bus is started after it returns
+bool twi_finishing = false;
+// Whether the running transaction is in reading, and bytes done so far
+// ... in writing or reading
+bool twi_reading;
+uint8_t twi_index;
 
-    // Generate start condition
-    TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
-    twi_wait_for_flag();
-    // Check status code
-    switch (TWSR & TW_STATUS_MASK) {
-    case TW_START:  // Start condition transmitted
-    case TW_REP_START:  // Repeated start condition transmitted
-        result = 0;
-        break;
-    default:
-        result = 1;
-        break;
+// Queue a transaction with interrupts disabled (from ISRs and callbacks);
+// ... the bus is started at once if idle
+void twi_submit_isr(twi_xfer_t* x) {
+    x->status = TWI_BUSY;
+    x->next = NULL;
+    if (twi_head) {
+        twi_tail->next = x;
+        twi_tail = x;
+    } else {
+        twi_head = twi_tail = x;
+        if (!twi_finishing) {
+            twi_reading = false;
+            twi_index = 0;
+            TWCR = TWCR_START;
+        }
     }
-    return result;
 }
 
-// Generate stop condition
-void twi_stop_condition() {
-    TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+// Queue a transaction from the main loop
+void twi_submit(twi_xfer_t* x) {
+    hal_disable_interrupts();
+    twi_submit_isr(x);
+    hal_enable_interrupts();
 }
 
-// Transmit address
-uint8_t twi_master_address(uint8_t addr) {
-    uint8_t result = 0;
-    
-    // Set address to register
-    TWDR = addr;
-    TWCR = (1 << TWINT) | (1 << TWEN);
-    twi_wait_for_flag();
-    if (addr & 0x01) {
-        // Master receiver mode
-        switch (TWSR & TW_STATUS_MASK) {
-        case TW_MR_SLA_ACK:  // SLA+R transmitted, ACK received
-            result = 0;
-            break;
-        case TW_MR_SLA_NACK:  // SLA+R transmitted, NACK received
-        default:
-            result = 1;
-            break;
-        }
-    } else {
-        // Master transmitter mode
-        switch (TWSR & TW_STATUS_MASK) {
-        case TW_MT_SLA_ACK:  // SLA+W transmitted, ACK received
-            result = 0;
-            break;
-        case TW_MT_SLA_NACK:  // SLA+W transmitted, NACK received
-        default:
-            result = 1;
-            break;
-        }
+// Wait for a transaction to complete, sleeping meanwhile; the status is
+// ... checked with interrupts disabled until sleeping, not to miss the
+// ... completion just before
+// ... return 0 if no error, 1 if error in communication
+uint8_t twi_wait(twi_xfer_t* x) {
+    hal_disable_interrupts();
+    while (x->status == TWI_BUSY) {
+        hal_idle();
+        hal_disable_interrupts();
     }
-    return result;
+    hal_enable_interrupts();
+    return x->status != TWI_OK;
 }
 
-// Transmit data in Master Transmitter mode
-uint8_t twi_master_transmit(uint8_t data) {
-    uint8_t result = 0;
+// Run a transaction and wait for its completion
+// ... return 0 if no error, 1 if error in communication
+uint8_t twi_transfer(twi_xfer_t* x) {
+    twi_submit(x);
+    return twi_wait(x);
+}
 
-    // Set data to register
-    TWDR = data;
-    TWCR = (1 << TWINT) | (1 << TWEN);
-    twi_wait_for_flag();
-    // Check status code
-    switch (TWSR & TW_STATUS_MASK) {
-    case TW_MT_DATA_ACK:  // data transmitted, ACK received
-        result = 0;
-        break;
-    case TW_MT_DATA_NACK:  // data transmitted, NACK received
-    default:
-        result = 1;
-        break;
+// Complete the running transaction, and go on to the next one in the
+// ... queue with a stop and a start condition in a row
+void twi_finish(uint8_t status) {
+    twi_xfer_t* x = twi_head;
+
+    trace_event_isr(TRACE_TWI_STOP, 0);
+    x->status = status;
+    // Dequeue before the callback, which may queue this one again;
+    // ... transactions queued by it follow the rest
+    twi_head = x->next;
+    if (x->done) {
+        twi_finishing = true;
+        x->done(x);
+        twi_finishing = false;
+    }
+    if (twi_head) {
+        twi_reading = false;
+        twi_index = 0;
+        TWCR = TWCR_STOP | TWCR_START;
+    } else {
+        TWCR = TWCR_STOP;
     }
-    return result;
 }
 
-// Receive data in Master Receiver mode
-uint8_t twi_master_receive(uint8_t* data, uint8_t ack) {
-    uint8_t result = 0;
+// TWI interrupt vector; a step of the running transaction per status
+ISR(TWI_vect) {
+    uint16_t t0 = profile_isr_begin();
+    twi_xfer_t* x = twi_head;
+    uint8_t addr;
 
-    // Set request to slave
-    TWCR = (1 << TWINT) | (!!ack << TWEA) | (1 << TWEN);
-    twi_wait_for_flag();
-    // Check status code
     switch (TWSR & TW_STATUS_MASK) {
+    case TW_START:  // Start condition transmitted
+    case TW_REP_START:  // Repeated start condition transmitted
+        // Read at once if nothing to write
+        if (x->tx_length == 0) {
+            twi_reading = true;
+        }
+        addr = (x->addr7 << 1) | (twi_reading ? 0x01 : 0x00);
+        trace_event_isr(TRACE_TWI_START, addr);
+        TWDR = addr;
+        TWCR = TWCR_CONTINUE;
+        break;
+    case TW_MT_SLA_ACK:  // SLA+W transmitted, ACK received
+    case TW_MT_DATA_ACK:  // data transmitted, ACK received
+        if (twi_index < x->tx_length) {
+            TWDR = x->tx[twi_index++];
+            TWCR = TWCR_CONTINUE;
+        } else if (x->rx_length) {
+            twi_reading = true;
+            twi_index = 0;
+            TWCR = TWCR_START;
+        } else {
+            twi_finish(TWI_OK);
+        }
+        break;
     case TW_MR_DATA_ACK:  // data received, ACK transmitted
+        x->rx[twi_index++] = TWDR;
+        // Fall through
+    case TW_MR_SLA_ACK:  // SLA+R transmitted, ACK received
+        // Acknowledge all but the last byte
+        TWCR = TWCR_CONTINUE |
+            (twi_index + 1 < x->rx_length ? (1 << TWEA) : 0);
+        break;
     case TW_MR_DATA_NACK:  // data received, NACK transmitted
-        *data = TWDR;
-        result = 0;
+        x->rx[twi_index] = TWDR;
+        twi_finish(TWI_OK);
         break;
-    default:
-        result = 1;
+    default:  // NACK from slave, arbitration lost or bus error
+        twi_finish(TWI_ERROR);
         break;
     }
-    return result;
+    profile_isr_end(PROFILE_TWI, t0);
 }
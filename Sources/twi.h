@@ -8,14 +8,40 @@
 #ifndef TWI_H_
 #define TWI_H_
 
-#define TWI_ACK   1
-#define TWI_NACK  0
+// Interrupt-driven TWI master;
+// ... transactions are queued and run by the TWI ISR one after another,
+// ... while the main loop goes on. A transaction writes its bytes to the
+// ... slave, then reads bytes after a repeated start if any to read, and
+// ... calls its callback from the ISR on completion
 
-void twi_wait_for_flag();
-uint8_t twi_start_condition();
-void twi_stop_condition();
-uint8_t twi_master_address(uint8_t addr);
-uint8_t twi_master_transmit(uint8_t data);
-uint8_t twi_master_receive(uint8_t* data, uint8_t ack);
+// Transaction status
+typedef enum {
+    TWI_OK,
+    TWI_ERROR,
+    TWI_BUSY
+} twi_status_t;
+
+// Transaction descriptor; kept by its owner until completed
+typedef struct twi_xfer {
+    // 7-bit slave address
+    uint8_t addr7;
+    // Bytes to write and to read; either may be none, but not both
+    const uint8_t* tx;
+    uint8_t tx_length;
+    uint8_t* rx;
+    uint8_t rx_length;
+    // Called by the TWI ISR on completion, or NULL; the transaction is
+    // ... off the queue by then, so the callback may submit it again
+    void (*done)(struct twi_xfer* x);
+    // twi_status_t; TWI_BUSY while queued or running
+    volatile uint8_t status;
+    // Next transaction in the queue
+    struct twi_xfer* next;
+} twi_xfer_t;
+
+void twi_submit_isr(twi_xfer_t* x);
+void twi_submit(twi_xfer_t* x);
+uint8_t twi_wait(twi_xfer_t* x);
+uint8_t twi_transfer(twi_xfer_t* x);
 
 #endif
@@ -0,0 +1,278 @@
+/*
+ * DotMatrixClock2018/ubx.c
+ *
+ *  Author: kayekss
+ *  Target: unspecified
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "ctime.h"
+#include "ubx.h"
+
+// Message and its decoding
+typedef struct {
+    // Class and ID
+    uint8_t message_class;
+    uint8_t id;
+    // Payload length
+    uint16_t length;
+    // Take the payload byte just received at the offset
+    void (*take)(ubx_t* p);
+    // Finish the result when the frame is validated
+    void (*finish)(ubx_t* p);
+} ubx_type_t;
+
+// Get the byte just received in the payload
+uint8_t ubx_byte(ubx_t* p) {
+    return p->last >> 24;
+}
+
+// Get milliseconds of nanoseconds just received as 4 bytes in the
+// ... payload; negative ones are of the time rounded up to the second
+// ... given, and taken as 0
+uint16_t ubx_ms(ubx_t* p) {
+    int32_t nano = (int32_t) p->last;
+
+    return nano > 0 ? nano / 1000000 : 0;
+}
+
+// Take a byte of NAV-PVT payload
+void ubx_take_nav_pvt(ubx_t* p) {
+    ubx_nav_pvt_t* pvt = &p->result.nav_pvt;
+
+    switch (p->offset) {
+    case 5:
+        pvt->year = p->last >> 16;
+        break;
+    case 6:
+        pvt->ct.mo = ubx_byte(p);
+        break;
+    case 7:
+        pvt->ct.d = ubx_byte(p);
+        break;
+    case 8:
+        pvt->ct.h = ubx_byte(p);
+        break;
+    case 9:
+        pvt->ct.m = ubx_byte(p);
+        break;
+    case 10:
+        pvt->ct.s = ubx_byte(p);
+        break;
+    case 11:
+        pvt->valid = ubx_byte(p);
+        break;
+    case 19:
+        pvt->ct.ms = ubx_ms(p);
+        break;
+    case 20:
+        pvt->fix_type = ubx_byte(p);
+        break;
+    case 21:
+        pvt->flags = ubx_byte(p);
+        break;
+    case 23:
+        pvt->sats_in_use = ubx_byte(p);
+        break;
+    default:
+        break;
+    }
+}
+
+// Take a byte of NAV-TIMEUTC payload
+void ubx_take_nav_timeutc(ubx_t* p) {
+    ubx_nav_timeutc_t* tu = &p->result.nav_timeutc;
+
+    switch (p->offset) {
+    case 11:
+        tu->ct.ms = ubx_ms(p);
+        break;
+    case 13:
+        tu->year = p->last >> 16;
+        break;
+    case 14:
+        tu->ct.mo = ubx_byte(p);
+        break;
+    case 15:
+        tu->ct.d = ubx_byte(p);
+        break;
+    case 16:
+        tu->ct.h = ubx_byte(p);
+        break;
+    case 17:
+        tu->ct.m = ubx_byte(p);
+        break;
+    case 18:
+        tu->ct.s = ubx_byte(p);
+        break;
+    case 19:
+        tu->valid = ubx_byte(p);
+        break;
+    default:
+        break;
+    }
+}
+
+// Localize clock time of UTC with the year
+// ... return true if the clock time is out of range, false if valid
+bool ubx_localize(ctime_t* ct, uint16_t year) {
+    ct->yh = year / 10 % 10;
+    ct->yl = year % 10;
+    // Seconds of 60 are of leap seconds, not kept by the clock
+    if (year < 2000 || year > 2099 || ctime_check_error(ct)) {
+        return true;
+    }
+    ctime_localize(ct, true);
+    return false;
+}
+
+// Finish NAV-PVT message validated
+void ubx_finish_nav_pvt(ubx_t* p) {
+    ubx_nav_pvt_t* pvt = &p->result.nav_pvt;
+
+    if (ubx_localize(&pvt->ct, pvt->year)) {
+        pvt->valid = 0x00;
+    }
+    // 2D, 3D, and GNSS with dead reckoning are of a fix if told OK
+    if ((pvt->flags & 0x01) && pvt->fix_type >= 2 && pvt->fix_type <= 4) {
+        pvt->status = (pvt->flags & 0x02) ? 2 : 1;
+    } else {
+        pvt->status = 0;
+    }
+}
+
+// Finish NAV-TIMEUTC message validated
+void ubx_finish_nav_timeutc(ubx_t* p) {
+    ubx_nav_timeutc_t* tu = &p->result.nav_timeutc;
+
+    if (ubx_localize(&tu->ct, tu->year)) {
+        tu->valid = 0x00;
+    }
+}
+
+// Messages by ubx_message_t from UBX_NAV_PVT; a message is added by an
+// ... entry here with its result structure
+PROGMEM ubx_type_t const ubx_types[UBX_MESSAGE_COUNT - UBX_NAV_PVT] = {
+    { 0x01, 0x07, 92, ubx_take_nav_pvt, ubx_finish_nav_pvt },
+    { 0x01, 0x21, 20, ubx_take_nav_timeutc, ubx_finish_nav_timeutc }
+};
+
+// Initialize parser with handlers indexed by ubx_message_t, in program
+// ... memory
+void ubx_initialize(ubx_t* p, const ubx_handler_t* handlers) {
+    p->handlers = handlers;
+    ubx_reset(p);
+}
+
+// Abandon the frame being parsed, and wait for the next one
+void ubx_reset(ubx_t* p) {
+    p->part = UBX_PART_NONE;
+}
+
+// Tell the message of the class and ID, if handled
+ubx_message_t ubx_message(ubx_t* p, uint8_t id) {
+    const ubx_type_t* t = NULL;
+
+    for (uint8_t m = UBX_NAV_PVT; m < UBX_MESSAGE_COUNT; m++) {
+        t = &ubx_types[m - UBX_NAV_PVT];
+        if (pgm_read_byte(&t->message_class) != p->message_class ||
+            pgm_read_byte(&t->id) != id) {
+            continue;
+        }
+        memcpy_P(&p->handler, &p->handlers[m], sizeof(p->handler));
+        return p->handler ? (ubx_message_t) m : UBX_NONE;
+    }
+    return UBX_NONE;
+}
+
+// Feed a received byte to the parser; the handler is called with the
+// ... result when a frame handled is complete and valid
+// ... return true if the byte is taken in a frame, false if not
+bool ubx_parse(ubx_t* p, uint8_t c) {
+    const ubx_type_t* t = NULL;
+    void (*f)(ubx_t* p);
+
+    switch (p->part) {
+    case UBX_PART_NONE:
+        if (c != UBX_SYNC1) {
+            return false;
+        }
+        p->part = UBX_PART_SYNC;
+        return true;
+    case UBX_PART_SYNC:
+        if (c != UBX_SYNC2) {
+            // Not a frame; the byte may start one or be of others
+            p->part = UBX_PART_NONE;
+            return ubx_parse(p, c);
+        }
+        p->part = UBX_PART_CLASS;
+        p->ck_a = 0x00;
+        p->ck_b = 0x00;
+        return true;
+    case UBX_PART_CLASS:
+        p->message_class = c;
+        p->part = UBX_PART_ID;
+        break;
+    case UBX_PART_ID:
+        p->message = ubx_message(p, c);
+        p->part = UBX_PART_LENGTH_LOW;
+        break;
+    case UBX_PART_LENGTH_LOW:
+        p->length = c;
+        p->part = UBX_PART_LENGTH_HIGH;
+        break;
+    case UBX_PART_LENGTH_HIGH:
+        p->length |= (uint16_t) c << 8;
+        if (p->length > UBX_LENGTH_MAX) {
+            p->part = UBX_PART_NONE;
+            return true;
+        }
+        // Frames of a length not expected are skipped
+        if (p->message != UBX_NONE) {
+            t = &ubx_types[p->message - UBX_NAV_PVT];
+            if (p->length != pgm_read_word(&t->length)) {
+                p->message = UBX_NONE;
+            }
+            memset(&p->result, 0, sizeof(p->result));
+        }
+        p->offset = 0;
+        p->part = p->length ? UBX_PART_PAYLOAD : UBX_PART_CK_A;
+        break;
+    case UBX_PART_PAYLOAD:
+        p->last = p->last >> 8 | (uint32_t) c << 24;
+        if (p->message != UBX_NONE) {
+            t = &ubx_types[p->message - UBX_NAV_PVT];
+            memcpy_P(&f, &t->take, sizeof(f));
+            f(p);
+        }
+        if (++p->offset == p->length) {
+            p->part = UBX_PART_CK_A;
+        }
+        break;
+    case UBX_PART_CK_A:
+        p->valid = c == p->ck_a;
+        p->part = UBX_PART_CK_B;
+        return true;
+    case UBX_PART_CK_B:
+        p->part = UBX_PART_NONE;
+        if (!p->valid || c != p->ck_b || p->message == UBX_NONE) {
+            return true;
+        }
+        t = &ubx_types[p->message - UBX_NAV_PVT];
+        memcpy_P(&f, &t->finish, sizeof(f));
+        f(p);
+        p->handler(p);
+        return true;
+    default:
+        p->part = UBX_PART_NONE;
+        return false;
+    }
+    // 8-bit Fletcher checksum over class, ID, length and payload
+    p->ck_a += c;
+    p->ck_b += p->ck_a;
+    return true;
+}
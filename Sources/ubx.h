@@ -0,0 +1,116 @@
+/*
+ * DotMatrixClock2018/ubx.h
+ *
+ *  Author: kayekss
+ *  Target: unspecified
+ */
+
+#ifndef UBX_H_
+#define UBX_H_
+
+// Streaming u-blox UBX protocol parser;
+// ... received bytes are fed one at a time, on the same input as NMEA
+// ... sentences. Frames are told by their sync characters, which are never
+// ... seen in NMEA sentences, and the Fletcher checksum is taken on the
+// ... way. Payload fields used are taken at their offsets from the last 4
+// ... bytes received, in little-endian, so no payload is buffered. Frames
+// ... of messages without a handler given by the caller are skipped
+
+// Sync characters
+#define UBX_SYNC1           0xb5
+#define UBX_SYNC2           0x62
+// Payload length taken as a frame; longer ones are of false sync
+#define UBX_LENGTH_MAX      1024
+
+// Messages recognized
+typedef enum {
+    UBX_NONE,
+    UBX_NAV_PVT,
+    UBX_NAV_TIMEUTC,
+    UBX_MESSAGE_COUNT
+} ubx_message_t;
+
+// Parts of a frame
+typedef enum {
+    // Out of frames, waiting for the first sync character
+    UBX_PART_NONE,
+    UBX_PART_SYNC,
+    UBX_PART_CLASS,
+    UBX_PART_ID,
+    UBX_PART_LENGTH_LOW,
+    UBX_PART_LENGTH_HIGH,
+    UBX_PART_PAYLOAD,
+    UBX_PART_CK_A,
+    UBX_PART_CK_B
+} ubx_part_t;
+
+// Result structure gathered from NAV-PVT message
+typedef struct {
+    // Localized clock time and date, and the year of UTC
+    ctime_t ct;
+    uint16_t year;
+    // Validity flags (bit 0: date, 1: time, 2: fully resolved); cleared
+    // ... if the clock time is out of range, including years out of
+    // ... 2000-2099
+    uint8_t valid;
+    // Fix type (0: no fix, 1: dead reckoning, 2: 2D, 3: 3D,
+    // ... 4: GNSS and dead reckoning, 5: time only)
+    uint8_t fix_type;
+    // Fix status flags (bit 0: fix OK, 1: differential)
+    uint8_t flags;
+    // Position fix status told by the above, in values of $__GGA
+    // ... (0: no fix, 1: fix, 2: differential fix)
+    uint8_t status;
+    // Satellites in use
+    uint8_t sats_in_use;
+} ubx_nav_pvt_t;
+
+// Result structure gathered from NAV-TIMEUTC message
+typedef struct {
+    // Localized clock time and date, and the year of UTC
+    ctime_t ct;
+    uint16_t year;
+    // Validity flags (bit 0: time of week, 1: week number, 2: UTC);
+    // ... cleared if the clock time is out of range, including years out
+    // ... of 2000-2099
+    uint8_t valid;
+} ubx_nav_timeutc_t;
+
+struct ubx;
+
+// Handler of a message given by the caller, in program memory;
+// ... called with the result when the frame is complete and valid, or
+// ... NULL to skip the message
+typedef void (*ubx_handler_t)(struct ubx* p);
+
+// Parser structure
+typedef struct ubx {
+    // Handlers indexed by ubx_message_t, in program memory
+    const ubx_handler_t* handlers;
+    // Part of the frame being parsed (ubx_part_t)
+    uint8_t part;
+    // Message being parsed, its class and handler
+    ubx_message_t message;
+    uint8_t message_class;
+    ubx_handler_t handler;
+    // Checksum so far, and whether the first byte given matches
+    uint8_t ck_a;
+    uint8_t ck_b;
+    bool valid;
+    // Payload length, and bytes received in the payload
+    uint16_t length;
+    uint16_t offset;
+    // Last 4 bytes received in the payload, in little-endian
+    uint32_t last;
+    // Result of the message
+    union {
+        ubx_nav_pvt_t nav_pvt;
+        ubx_nav_timeutc_t nav_timeutc;
+    } result;
+} ubx_t;
+
+void ubx_initialize(ubx_t* p, const ubx_handler_t* handlers);
+void ubx_reset(ubx_t* p);
+bool ubx_parse(ubx_t* p, uint8_t c);
+
+#endif
@@ -7,130 +7,66 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdlib.h>
-#include <avr/io.h>
+#include <avr/pgmspace.h>
 #include "usart.h"
 
-// Send a byte over USART
-inline void usart_putc(uint8_t d) {
-    // Wait until transmit register is ready
-    while (!(UCSR0A & (1 << UDRE0)));
-    // Clear transmission complete flag
-    UCSR0A |= (1 << TXC0);
-    // Set data byte
-    UDR0 = d;
-}
-
-// Send a string over USART
-void usart_puts(char* s) {
-    while (*s) {
-        usart_putc(*s++);
-    }
-}
-
-// Allocate memory for buffer entity
-void linebuf_allocate(linebuf_t* b, uint16_t length) {
-    b->data = calloc(length, sizeof(uint8_t));
-    b->length = b->data ? length : 0;
-}
-
-// Deallocate memory for buffer entity
-void linebuf_deallocate(linebuf_t* b) {
-    free(b->data);    
-}
-
-// Initialize line buffer structure
-void linebuf_initialize(linebuf_t* b, uint16_t length) {
-    b->length = 0;
-    b->data = NULL;
-    linebuf_allocate(b, length);
-    b->count = 0;
-}
-
-// Check if any data is available
-inline bool linebuf_available(linebuf_t* b) {
-    return b->count > 0;
-}
+// Baud rates by usart_rate_t
+PROGMEM uint32_t const usart_bauds[USART_RATE_COUNT] = {
+    4800, 9600, 19200, 38400, 57600, 115200
+};
 
-// Clear all data
-inline void linebuf_clear(linebuf_t* b) {
-    b->count = 0;
+// Get the baud rate
+uint32_t usart_baud(usart_rate_t rate) {
+    return pgm_read_dword(&usart_bauds[rate]);
 }
 
-// Put a data byte into the buffer
-// ... return zero on success, non-zero on failure
-inline uint8_t linebuf_put(linebuf_t* b, uint8_t c) {
-    if (b->count == b->length) {
-        return 1;
-    } else {
-        b->data[b->count++] = c;
-        return 0;
-    }
-}
-
-// Allocate memory for buffer entity
-void ringbuf_allocate(ringbuf_t* b, uint16_t length) {
-    b->data = calloc(length, sizeof(uint8_t));
-    b->length = length;
-}
-
-// Deallocate memory for buffer entity
-void ringbuf_deallocate(ringbuf_t* b) {
-    free(b->data);
-}
-
-// Initialize ring buffer structure
-void ringbuf_initialize(ringbuf_t* b, uint16_t length) {
+// Initialize ring buffer structure on buffer data of a length of a power
+// ... of 2 up to 128
+void ringbuf_initialize(ringbuf_t* b, uint8_t* data, uint8_t length) {
+    b->mask = length - 1;
     b->rp = 0;
     b->wp = 0;
-    b->full = false;
-    b->data = NULL;
-    ringbuf_allocate(b, length);
+    b->overruns = 0;
+    b->data = data;
 }
 
 // Check if any data is available
 inline bool ringbuf_available(ringbuf_t* b) {
-    return b->full || b->rp != b->wp;
+    return b->rp != b->wp;
 }
 
-// Clear all data
+// Clear all data; by the consumer
 inline void ringbuf_clear(ringbuf_t* b) {
-    b->wp = b->rp;
-    b->full = false;
+    b->rp = b->wp;
 }
 
-// Put a data byte into the buffer
+// Put a data byte into the buffer; by the producer
 // ... return zero on success, non-zero on failure
 inline uint8_t ringbuf_put(ringbuf_t* b, uint8_t c) {
-    uint8_t result = 0;
-    
-    if (b->full) {
-        result = 1;
-    } else {
-        b->data[b->wp] = c;
-        // Advance write pointer
-        b->wp = b->wp >= b->length - 1 ? 0 : b->wp + 1;
-        // Check if buffer is full
-        b->full = b->wp == b->rp;
-        result = 0;
+    uint8_t wp = b->wp;
+
+    if ((uint8_t) (wp - b->rp) > b->mask) {
+        if (b->overruns != UINT16_MAX) {
+            b->overruns++;
+        }
+        return 1;
     }
-    return result;
+    b->data[wp & b->mask] = c;
+    // Advance write pointer after the data byte is stored
+    b->wp = wp + 1;
+    return 0;
 }
 
-// Get a data byte from the buffer
+// Get a data byte from the buffer; by the consumer
 // ... return zero on success, non-zero on failure
 inline uint8_t ringbuf_get(ringbuf_t* b, uint8_t* c) {
-    uint8_t result = 0;
-    
-    if (ringbuf_available(b)) {
-        *c = b->data[b->rp];
-        // Advance read pointer
-        b->rp = b->rp >= b->length - 1 ? 0 : b->rp + 1; 
-        // Clear full flag
-        b->full = false;
-        result = 0;
-    } else {
-        result = 1;
+    uint8_t rp = b->rp;
+
+    if (rp == b->wp) {
+        return 1;
     }
-    return result;
+    *c = b->data[rp & b->mask];
+    // Advance read pointer after the data byte is taken
+    b->rp = rp + 1;
+    return 0;
 }
@@ -8,41 +8,46 @@
 #ifndef USART_H_
 #define USART_H_
 
-// Line buffer structure
+// Ring buffer structure;
+// ... a single producer puts bytes and a single consumer gets them, such
+// ... as an ISR and the main loop, without disabling interrupts. Pointers
+// ... run freely and are masked into the buffer data, whose length is a
+// ... power of 2 up to 128; each of them is written by its own side only
 typedef struct {
-    // Length of buffer data
-    uint8_t length;
-    // Data bytes currently stored
-    volatile uint8_t count;
+    // Length of buffer data minus 1
+    uint8_t mask;
+    // Write pointer, written by the producer
+    volatile uint8_t wp;
+    // Read pointer, written by the consumer
+    volatile uint8_t rp;
+    // Bytes dropped as the buffer was full, up to 65535; written by the
+    // ... producer, and read by the other side with interrupts disabled
+    volatile uint16_t overruns;
     // Buffer data entity
-    uint8_t *data;
-} linebuf_t;
+    volatile uint8_t *data;
+} ringbuf_t;
 
-// Ring buffer structure
+// USART receiver error counts, up to 65535
 typedef struct {
-    // Length of buffer data
-    uint8_t length;
-    // Read pointer
-    uint8_t rp;
-    // Write pointer
-    uint8_t wp;
-    // Buffer full flag (0: empty, 1: full when rp equals to wp)
-    bool full;
-    // Buffer data entity
-    uint8_t *data;
-} ringbuf_t;
+    // Bytes received while the receiver buffer of USART was full
+    uint16_t data_overruns;
+    // Bytes received without a valid stop bit
+    uint16_t frame_errors;
+} usart_errors_t;
+
+// Baud rates selectable, from the lowest
+typedef enum {
+    USART_4800,
+    USART_9600,
+    USART_19200,
+    USART_38400,
+    USART_57600,
+    USART_115200,
+    USART_RATE_COUNT
+} usart_rate_t;
 
-void usart_putc(uint8_t d);
-void usart_puts(char* s);
-void linebuf_allocate(linebuf_t* b, uint16_t length);
-void linebuf_deallocate(linebuf_t* b);
-void linebuf_initialize(linebuf_t* b, uint16_t length);
-bool linebuf_available(linebuf_t* b);
-void linebuf_clear(linebuf_t* b);
-uint8_t linebuf_put(linebuf_t* b, uint8_t c);
-void ringbuf_allocate(ringbuf_t* b, uint16_t length);
-void ringbuf_deallocate(ringbuf_t* b);
-void ringbuf_initialize(ringbuf_t* b, uint16_t length);
+uint32_t usart_baud(usart_rate_t rate);
+void ringbuf_initialize(ringbuf_t* b, uint8_t* data, uint8_t length);
 bool ringbuf_available(ringbuf_t* b);
 void ringbuf_clear(ringbuf_t* b);
 uint8_t ringbuf_put(ringbuf_t* b, uint8_t c);
@@ -0,0 +1,564 @@
+/*
+ * DotMatrixClock2018/Tools/bench/bench.c
+ *
+ *  Author: kayekss
+ *  Target: native build with simavr
+ *
+ * Runs the firmware image on simavr and reports cycles of interrupt
+ * service routines, their latency, main loop pass time per state, cycles
+ * and latency of scheduler tasks, the scheduler's dispatch overhead, and
+ * the share of cycles the CPU sleeps.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/sim_irq.h>
+#include <simavr/sim_interrupts.h>
+#include <simavr/avr_ioport.h>
+#include <simavr/avr_uart.h>
+#include "../../Sources/bench.h"
+#include "../../Sources/sched.h"
+
+#define F_CPU  20000000ul
+
+// Data space addresses of general purpose I/O registers (ATmega328P)
+#define ADDR_GPIOR0  0x3e
+#define ADDR_GPIOR1  0x4a
+#define ADDR_GPIOR2  0x4b
+
+// Interrupt response time in cycles, not seen by the simulator hooks
+#define INT_RESPONSE_CYCLES  4
+
+// Events in scenario
+#define EVENTS_MAX  256
+
+// Interrupt vectors to measure
+typedef struct {
+    uint8_t vector;
+    const char* name;
+    // Cycles when the flag was raised (0: not pending) and the ISR entered
+    avr_cycle_count_t raised;
+    avr_cycle_count_t entered;
+    // Statistics
+    uint64_t count;
+    uint64_t cycles_total;
+    uint32_t cycles_max;
+    uint32_t latency_max;
+    // Least latency (UINT32_MAX: none yet); the spread from the worst one
+    // ... is the jitter of the ISR, e.g. of display scan timing
+    uint32_t latency_min;
+} isr_stat_t;
+
+isr_stat_t isrs[] = {
+    { 11, "TIMER1_COMPA_vect" },
+    { 14, "TIMER0_COMPA_vect" },
+    { 18, "USART_RX_vect" },
+    { 19, "USART_UDRE_vect" },
+    { 24, "TWI_vect" }
+};
+#define ISR_COUNT  (sizeof(isrs) / sizeof(isrs[0]))
+
+// Main loop statistics per state
+typedef struct {
+    uint64_t count;
+    uint64_t gross_total;
+    uint64_t net_total;
+    uint32_t gross_max;
+    uint32_t net_max;
+} loop_stat_t;
+
+loop_stat_t loops[256];
+
+// Scheduler task statistics, net of interrupts
+typedef struct {
+    uint64_t count;
+    uint64_t cycles_total;
+    uint32_t cycles_max;
+    // Worst-case latency in milliseconds, reported by the firmware
+    uint8_t latency_max;
+} task_stat_t;
+
+const char* const task_names[TASK_COUNT] = {
+    [TASK_ADVANCE_CLOCK] = "advance_clock",
+    [TASK_READ_KEYS] = "read_keys",
+    [TASK_DRAW_SCREEN] = "draw_screen",
+    [TASK_HANDLE_RX] = "handle_rx",
+    [TASK_CHECK_RELAY_OUTPUT] = "check_relay_output",
+    [TASK_SERIAL_OUTPUT] = "serial_output",
+    [TASK_SET_BRIGHTNESS] = "set_brightness",
+    [TASK_READ_TEMPERATURE] = "read_temperature",
+    [TASK_UPDATE_TEMPERATURE] = "update_temperature",
+    [TASK_SAVE_CTIME_TO_RTC] = "save_ctime_to_rtc",
+    [TASK_DETECT_BAUD] = "detect_baud",
+    [TASK_BOOT] = "boot",
+#ifdef PROFILER
+    [TASK_PROFILE_DUMP] = "profile_dump",
+#endif
+#ifdef TRACE
+    [TASK_TRACE_DRAIN] = "trace_drain",
+#endif
+};
+
+task_stat_t task_stats[TASK_COUNT];
+
+// Dispatch overhead; net cycles of passes running a task, less the task
+struct {
+    uint64_t count;
+    uint64_t cycles_total;
+    uint32_t cycles_max;
+} dispatch;
+
+// Scenario event; key press or serial input line
+typedef struct {
+    avr_cycle_count_t at;
+    avr_cycle_count_t until;
+    int key;
+    char* text;
+    // Progress (0: not started, 1: key pressed, 2: done)
+    uint8_t phase;
+} event_t;
+
+struct {
+    avr_t* avr;
+    // Scenario
+    event_t events[EVENTS_MAX];
+    int event_count;
+    // Cycles of the next event to apply
+    avr_cycle_count_t next_event;
+    // Values written last to GPIOR1 (state or task ID) and GPIOR2
+    uint8_t state;
+    uint8_t latency;
+    // Cycles of the last loop marker and ISR cycles spent since then
+    avr_cycle_count_t loop_mark;
+    uint64_t loop_isr_cycles;
+    bool loop_marked;
+    // Task running in the pass, its start cycles and ISR cycles at start
+    int task;
+    avr_cycle_count_t task_mark;
+    uint64_t task_isr_cycles;
+    // Net cycles of the task run in the pass (-1: none)
+    int64_t task_net;
+    // Cycles spent sleeping
+    avr_cycle_count_t sleep_cycles;
+    // Cycles from reset to the first frame shown and to the end of
+    // ... startup (0: not yet)
+    avr_cycle_count_t first_frame;
+    avr_cycle_count_t boot_done;
+} bench;
+
+// Get statistics entry of the vector
+isr_stat_t* find_isr(uint8_t vector) {
+    for (unsigned i = 0; i < ISR_COUNT; i++) {
+        if (isrs[i].vector == vector) {
+            return &isrs[i];
+        }
+    }
+    return NULL;
+}
+
+// Interrupt flag raised
+void on_pending(struct avr_irq_t* irq, uint32_t value, void* param) {
+    isr_stat_t* s = param;
+
+    if (value && !s->raised) {
+        s->raised = bench.avr->cycle;
+    }
+}
+
+// Interrupt service routine entered (value 1) or returned (value 0)
+void on_running(struct avr_irq_t* irq, uint32_t value, void* param) {
+    isr_stat_t* s = param;
+    uint32_t cycles;
+
+    if (value) {
+        s->entered = bench.avr->cycle;
+        if (s->raised) {
+            cycles = s->entered - s->raised;
+            if (cycles > s->latency_max) {
+                s->latency_max = cycles;
+            }
+            if (cycles < s->latency_min) {
+                s->latency_min = cycles;
+            }
+        }
+        s->raised = 0;
+    } else if (s->entered) {
+        cycles = bench.avr->cycle - s->entered + INT_RESPONSE_CYCLES;
+        s->count++;
+        s->cycles_total += cycles;
+        if (cycles > s->cycles_max) {
+            s->cycles_max = cycles;
+        }
+        bench.loop_isr_cycles += cycles;
+        s->entered = 0;
+    }
+}
+
+// State or task ID written to GPIOR1
+void on_gpior1(struct avr_t* avr, avr_io_addr_t addr, uint8_t v, void* param) {
+    bench.state = v;
+}
+
+// Task latency written to GPIOR2
+void on_gpior2(struct avr_t* avr, avr_io_addr_t addr, uint8_t v, void* param) {
+    bench.latency = v;
+}
+
+// Task marker written to GPIOR0
+void mark_task(struct avr_t* avr, uint8_t v) {
+    task_stat_t* t;
+    uint32_t net;
+
+    if (v == BENCH_MARK_TASK) {
+        bench.task = bench.state < TASK_COUNT ? bench.state : -1;
+        bench.task_mark = avr->cycle;
+        bench.task_isr_cycles = bench.loop_isr_cycles;
+        if (bench.task >= 0 && bench.latency > task_stats[bench.task]
+            .latency_max) {
+            task_stats[bench.task].latency_max = bench.latency;
+        }
+    } else if (bench.task >= 0) {
+        net = avr->cycle - bench.task_mark -
+            (bench.loop_isr_cycles - bench.task_isr_cycles);
+        t = &task_stats[bench.task];
+        t->count++;
+        t->cycles_total += net;
+        if (net > t->cycles_max) {
+            t->cycles_max = net;
+        }
+        bench.task_net = net;
+        bench.task = -1;
+    }
+}
+
+// Marker written to GPIOR0; a loop marker closes the previous pass
+void on_gpior0(struct avr_t* avr, avr_io_addr_t addr, uint8_t v, void* param) {
+    static uint8_t state = 0;
+    loop_stat_t* l;
+    uint32_t gross, net, overhead;
+
+    if (v == BENCH_MARK_TASK || v == BENCH_MARK_TASK_END) {
+        mark_task(avr, v);
+        return;
+    }
+    if (v == BENCH_MARK_FRAME && !bench.first_frame) {
+        bench.first_frame = avr->cycle;
+    }
+    if (v == BENCH_MARK_BOOT_DONE && !bench.boot_done) {
+        bench.boot_done = avr->cycle;
+    }
+    if (v != BENCH_MARK_LOOP) {
+        return;
+    }
+    if (bench.loop_marked) {
+        gross = avr->cycle - bench.loop_mark;
+        net = gross - bench.loop_isr_cycles;
+        l = &loops[state];
+        l->count++;
+        l->gross_total += gross;
+        l->net_total += net;
+        if (gross > l->gross_max) {
+            l->gross_max = gross;
+        }
+        if (net > l->net_max) {
+            l->net_max = net;
+        }
+        if (bench.task_net >= 0) {
+            overhead = net - bench.task_net;
+            dispatch.count++;
+            dispatch.cycles_total += overhead;
+            if (overhead > dispatch.cycles_max) {
+                dispatch.cycles_max = overhead;
+            }
+        }
+    }
+    bench.task_net = -1;
+    state = bench.state;
+    bench.loop_mark = avr->cycle;
+    bench.loop_isr_cycles = 0;
+    bench.loop_marked = true;
+}
+
+// Load scenario; lines of "MS key KEY DURATION_MS" or "MS serial TEXT"
+void load_scenario(const char* path) {
+    FILE* f = fopen(path, "r");
+    char line[256];
+    char text[256];
+    unsigned long ms, duration;
+    int key;
+    event_t* e;
+
+    if (!f) {
+        perror(path);
+        exit(2);
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (bench.event_count == EVENTS_MAX) {
+            break;
+        }
+        e = &bench.events[bench.event_count];
+        memset(e, 0, sizeof(*e));
+        e->key = -1;
+        if (sscanf(line, "%lu key %d %lu", &ms, &key, &duration) == 3) {
+            e->key = key;
+            e->until = (ms + duration) * (F_CPU / 1000);
+        } else if (sscanf(line, "%lu serial %255[^\n]", &ms, text) == 2) {
+            e->text = strdup(text);
+        } else {
+            continue;
+        }
+        e->at = ms * (F_CPU / 1000);
+        bench.event_count++;
+    }
+    fclose(f);
+}
+
+// Apply scenario events due and find the next one
+void run_events() {
+    avr_t* avr = bench.avr;
+    avr_irq_t* uart = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'),
+        UART_IRQ_INPUT);
+    avr_irq_t* pin;
+
+    bench.next_event = ~(avr_cycle_count_t) 0;
+    for (int i = 0; i < bench.event_count; i++) {
+        event_t* e = &bench.events[i];
+
+        if (e->phase == 0 && avr->cycle >= e->at) {
+            if (e->key >= 0) {
+                // Keys are low-active on PC0 and PC1
+                pin = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('C'),
+                    e->key);
+                avr_raise_irq(pin, 0);
+                e->phase = 1;
+            } else {
+                // The UART model paces queued bytes at the baud rate
+                for (char* p = e->text; *p; p++) {
+                    avr_raise_irq(uart, (uint8_t) *p);
+                }
+                avr_raise_irq(uart, '\r');
+                avr_raise_irq(uart, '\n');
+                e->phase = 2;
+            }
+        } else if (e->phase == 1 && avr->cycle >= e->until) {
+            pin = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('C'), e->key);
+            avr_raise_irq(pin, 1);
+            e->phase = 2;
+        }
+        if (e->phase == 0 && e->at < bench.next_event) {
+            bench.next_event = e->at;
+        } else if (e->phase == 1 && e->until < bench.next_event) {
+            bench.next_event = e->until;
+        }
+    }
+}
+
+// Spread of latency of an ISR in cycles
+uint32_t isr_jitter(isr_stat_t* s) {
+    return s->latency_min == UINT32_MAX ? 0 : s->latency_max - s->latency_min;
+}
+
+// Share of all cycles spent in ISRs
+double isr_percent() {
+    uint64_t total = 0;
+
+    for (unsigned i = 0; i < ISR_COUNT; i++) {
+        total += isrs[i].cycles_total;
+    }
+    return 100.0 * total / bench.avr->cycle;
+}
+
+void write_json(FILE* f, const char* firmware) {
+    bool first = true;
+
+    fprintf(f, "{\n  \"firmware\": \"%s\",\n  \"isr\": {\n", firmware);
+    for (unsigned i = 0; i < ISR_COUNT; i++) {
+        isr_stat_t* s = &isrs[i];
+        fprintf(f, "    \"%s\": {\"count\": %llu, \"cycles_mean\": %.1f, "
+            "\"cycles_max\": %u, \"latency_max\": %u, \"jitter\": %u}%s\n",
+            s->name, (unsigned long long) s->count,
+            s->count ? (double) s->cycles_total / s->count : 0.0,
+            s->cycles_max, s->latency_max, isr_jitter(s),
+            i + 1 < ISR_COUNT ? "," : "");
+    }
+    fprintf(f, "  },\n  \"loop\": {\n");
+    for (int state = 0; state < 256; state++) {
+        loop_stat_t* l = &loops[state];
+        if (!l->count) {
+            continue;
+        }
+        fprintf(f, "%s    \"0x%02x\": {\"count\": %llu, \"gross_mean\": %.1f, "
+            "\"gross_max\": %u, \"net_mean\": %.1f, \"net_max\": %u}",
+            first ? "" : ",\n", state, (unsigned long long) l->count,
+            (double) l->gross_total / l->count, l->gross_max,
+            (double) l->net_total / l->count, l->net_max);
+        first = false;
+    }
+    fprintf(f, "\n  },\n  \"task\": {\n");
+    for (int i = 0; i < TASK_COUNT; i++) {
+        task_stat_t* t = &task_stats[i];
+        fprintf(f, "    \"%s\": {\"count\": %llu, \"cycles_mean\": %.1f, "
+            "\"cycles_max\": %u, \"latency_max\": %u}%s\n", task_names[i],
+            (unsigned long long) t->count,
+            t->count ? (double) t->cycles_total / t->count : 0.0,
+            t->cycles_max, t->latency_max, i + 1 < TASK_COUNT ? "," : "");
+    }
+    fprintf(f, "  },\n  \"dispatch\": {\"count\": %llu, "
+        "\"cycles_mean\": %.1f, \"cycles_max\": %u},\n",
+        (unsigned long long) dispatch.count,
+        dispatch.count ? (double) dispatch.cycles_total / dispatch.count : 0.0,
+        dispatch.cycles_max);
+    fprintf(f, "  \"boot\": {\"first_frame_us\": %.1f, \"done_us\": %.1f},\n",
+        bench.first_frame * 1e6 / F_CPU, bench.boot_done * 1e6 / F_CPU);
+    fprintf(f, "  \"isr_percent\": %.2f,\n", isr_percent());
+    fprintf(f, "  \"sleep_percent\": %.2f\n}\n",
+        100.0 * bench.sleep_cycles / bench.avr->cycle);
+}
+
+void print_report() {
+    printf("%-20s %10s %10s %8s %8s %8s\n",
+        "ISR", "count", "mean", "max", "latency", "jitter");
+    for (unsigned i = 0; i < ISR_COUNT; i++) {
+        isr_stat_t* s = &isrs[i];
+        printf("%-20s %10llu %10.1f %8u %8u %8u\n", s->name,
+            (unsigned long long) s->count,
+            s->count ? (double) s->cycles_total / s->count : 0.0,
+            s->cycles_max, s->latency_max, isr_jitter(s));
+    }
+    printf("ISRs %.2f%% of cycles\n", isr_percent());
+    printf("\n%-6s %10s %10s %8s %10s %8s\n",
+        "state", "passes", "gross", "max", "net", "max");
+    for (int state = 0; state < 256; state++) {
+        loop_stat_t* l = &loops[state];
+        if (l->count) {
+            printf("0x%02x   %10llu %10.1f %8u %10.1f %8u\n", state,
+                (unsigned long long) l->count,
+                (double) l->gross_total / l->count, l->gross_max,
+                (double) l->net_total / l->count, l->net_max);
+        }
+    }
+    printf("\n%-20s %10s %10s %8s %8s\n",
+        "task", "count", "mean", "max", "latency");
+    for (int i = 0; i < TASK_COUNT; i++) {
+        task_stat_t* t = &task_stats[i];
+        printf("%-20s %10llu %10.1f %8u %6u ms\n", task_names[i],
+            (unsigned long long) t->count,
+            t->count ? (double) t->cycles_total / t->count : 0.0,
+            t->cycles_max, t->latency_max);
+    }
+    printf("%-20s %10llu %10.1f %8u\n", "(dispatch)",
+        (unsigned long long) dispatch.count,
+        dispatch.count ? (double) dispatch.cycles_total / dispatch.count : 0.0,
+        dispatch.cycles_max);
+    printf("\nfirst frame %.1f us, startup done %.1f us after reset\n",
+        bench.first_frame * 1e6 / F_CPU, bench.boot_done * 1e6 / F_CPU);
+    printf("sleep %.2f%% of %llu cycles\n",
+        100.0 * bench.sleep_cycles / bench.avr->cycle,
+        (unsigned long long) bench.avr->cycle);
+}
+
+void usage(const char* name) {
+    fprintf(stderr, "usage: %s [-t SECONDS] [-o RESULT_JSON] "
+        "FIRMWARE_ELF SCENARIO\n", name);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    elf_firmware_t fw = { { 0 } };
+    avr_cycle_count_t end;
+    double seconds = 30;
+    const char* result = NULL;
+    int opt;
+    int state;
+    avr_cycle_count_t cycle;
+    bool sleeping;
+    FILE* f;
+
+    while ((opt = getopt(argc, argv, "t:o:")) != -1) {
+        switch (opt) {
+        case 't':
+            seconds = atof(optarg);
+            break;
+        case 'o':
+            result = optarg;
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    if (argc - optind != 2) {
+        usage(argv[0]);
+    }
+    if (elf_read_firmware(argv[optind], &fw)) {
+        fprintf(stderr, "%s: cannot read firmware\n", argv[optind]);
+        return 1;
+    }
+    load_scenario(argv[optind + 1]);
+
+    bench.avr = avr_make_mcu_by_name("atmega328p");
+    if (!bench.avr) {
+        fprintf(stderr, "atmega328p is not supported by simavr\n");
+        return 1;
+    }
+    avr_init(bench.avr);
+    fw.frequency = F_CPU;
+    avr_load_firmware(bench.avr, &fw);
+
+    // Hook interrupts and markers
+    for (unsigned i = 0; i < ISR_COUNT; i++) {
+        avr_irq_t* irq = avr_get_interrupt_irq(bench.avr, isrs[i].vector);
+        isrs[i].latency_min = UINT32_MAX;
+        avr_irq_register_notify(irq + AVR_INT_IRQ_PENDING, on_pending,
+            &isrs[i]);
+        avr_irq_register_notify(irq + AVR_INT_IRQ_RUNNING, on_running,
+            &isrs[i]);
+    }
+    avr_register_io_write(bench.avr, ADDR_GPIOR0, on_gpior0, NULL);
+    avr_register_io_write(bench.avr, ADDR_GPIOR1, on_gpior1, NULL);
+    avr_register_io_write(bench.avr, ADDR_GPIOR2, on_gpior2, NULL);
+    bench.task = -1;
+    bench.task_net = -1;
+    // Keys are released; pull-ups are not modeled by simavr
+    for (int k = 0; k < 2; k++) {
+        avr_raise_irq(avr_io_getirq(bench.avr,
+            AVR_IOCTL_IOPORT_GETIRQ('C'), k), 1);
+    }
+
+    end = (avr_cycle_count_t) (seconds * F_CPU);
+    do {
+        if (bench.avr->cycle >= bench.next_event) {
+            run_events();
+        }
+        cycle = bench.avr->cycle;
+        sleeping = bench.avr->state == cpu_Sleeping;
+        state = avr_run(bench.avr);
+        if (sleeping) {
+            bench.sleep_cycles += bench.avr->cycle - cycle;
+        }
+    } while (bench.avr->cycle < end &&
+        state != cpu_Done && state != cpu_Crashed);
+    if (state == cpu_Crashed) {
+        fprintf(stderr, "firmware crashed at cycle %llu\n",
+            (unsigned long long) bench.avr->cycle);
+        return 1;
+    }
+
+    print_report();
+    if (result) {
+        f = fopen(result, "w");
+        if (!f) {
+            perror(result);
+            return 1;
+        }
+        write_json(f, argv[optind]);
+        fclose(f);
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+#
+# DotMatrixClock2018/Tools/bench/compare.py
+#
+#  Author: kayekss
+#
+# Compares a benchmark result with the baseline; exits with status 1 if any
+# maximum cycle count exceeds its baseline by more than the tolerance.
+#
+# Usage: compare.py [-t TOLERANCE_PERCENT] BASELINE_JSON RESULT_JSON
+
+import argparse
+import json
+import sys
+
+# Metrics compared; means are shown but not judged
+ISR_METRICS = ('cycles_max', 'latency_max')
+LOOP_METRICS = ('gross_max', 'net_max')
+TASK_METRICS = ('cycles_max', 'latency_max')
+DISPATCH_METRICS = ('cycles_max',)
+BOOT_METRICS = ('first_frame_us', 'done_us')
+
+
+def compare(group, base, result, metrics, tolerance):
+    regressions = 0
+    for name in sorted(set(base) | set(result)):
+        if name not in base or name not in result:
+            print('{} {}: only in {}'.format(
+                group, name, 'baseline' if name in base else 'result'))
+            continue
+        for metric in metrics:
+            old = base[name][metric]
+            new = result[name][metric]
+            change = (new - old) * 100.0 / old if old else 0.0
+            mark = ''
+            if change > tolerance:
+                mark = '  REGRESSION'
+                regressions += 1
+            print('{} {} {}: {} -> {} ({:+.1f}%){}'.format(
+                group, name, metric, old, new, change, mark))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare benchmarks.')
+    parser.add_argument('-t', '--tolerance', type=float, default=5.0,
+                        help='allowed increase in percent (default 5)')
+    parser.add_argument('baseline')
+    parser.add_argument('result')
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        base = json.load(f)
+    with open(args.result) as f:
+        result = json.load(f)
+    regressions = compare('isr', base['isr'], result['isr'], ISR_METRICS,
+                          args.tolerance)
+    regressions += compare('loop', base['loop'], result['loop'],
+                           LOOP_METRICS, args.tolerance)
+    # Baselines taken before the scheduler have no task statistics
+    regressions += compare('task', base.get('task', {}),
+                           result.get('task', {}), TASK_METRICS,
+                           args.tolerance)
+    if 'dispatch' in base and 'dispatch' in result:
+        regressions += compare('dispatch', {'all': base['dispatch']},
+                               {'all': result['dispatch']}, DISPATCH_METRICS,
+                               args.tolerance)
+    if 'boot' in base and 'boot' in result:
+        regressions += compare('boot', {'all': base['boot']},
+                               {'all': result['boot']}, BOOT_METRICS,
+                               args.tolerance)
+    if regressions:
+        print('{} regression(s)'.format(regressions))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
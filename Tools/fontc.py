@@ -0,0 +1,309 @@
+#!/usr/bin/env python3
+#
+# DotMatrixClock2018/Tools/fontc.py
+#
+#  Author: kayekss
+#
+# Font compiler; converts ASCII-art font sources in Tools/fonts/ into the
+# PROGMEM tables of Sources/fonts.c and Sources/fonts.h.
+#
+# Source format ("# " starts a comment line, "  #" a trailing comment):
+#   font NAME height H (width W | proportional) [packed]
+#   glyph (default | CODE)  [# comment]
+#   ROW ... (H rows of "#": lit dot, ".": unlit dot, "-": zero-width row)
+#
+# Output format per font:
+#   font_ranges_NAME  triplets of { first code, last code, first glyph },
+#                     codes out of ranges use glyph 0 ("default")
+#   font_bitmap_NAME  glyphs in a fixed stride; proportional fonts have
+#                     1 width byte on each glyph head, packed fonts (width 4
+#                     or less) have 2 lines per byte, upper nibble first
+#   Packed proportional fonts (height 5) split glyphs in two tables:
+#   font_bitmap_NAME  glyphs of width 5 or less, numbered first, in 4 bytes;
+#                     line 0..3 in lower 5 bits of byte 0..3, line 4 in
+#                     upper 3 bits of byte 0 and 1 (lower bits first) and
+#                     width in upper 3 bits of byte 2
+#   font_wide_NAME    wider glyphs numbered from FONT_NAME_NARROW, with 1
+#                     width byte on each glyph head
+#
+# Usage: fontc.py [-o OUTPUT_DIR] SOURCE...
+
+import argparse
+import os
+import sys
+
+HEADER = """/*
+ * DotMatrixClock2018/{name}
+ *
+ *  Author: kayekss
+ *  Target: ATmega328P, 20.000 MHz crystal oscillator
+ *
+ *  Generated by Tools/fontc.py from Tools/fonts/; do not edit by hand.
+ */
+"""
+
+
+class Font:
+    def __init__(self, name, height, width, packed):
+        self.name = name
+        self.height = height
+        # Width of monospaced fonts, None for proportional fonts
+        self.width = width
+        self.packed = packed
+        # List of (code or None for default, comment, rows)
+        self.glyphs = []
+
+
+def fail(path, lineno, message):
+    sys.exit('{}:{}: {}'.format(path, lineno, message))
+
+
+def parse(path):
+    fonts = []
+    font = None
+    glyph = None
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            # Rows never contain spaces while comments always do
+            if line.startswith('# '):
+                continue
+            text, _, comment = line.partition('  #')
+            words = text.split()
+            if not words:
+                continue
+            if words[0] == 'font':
+                name = words[1]
+                opts = words[2:]
+                height = int(opts[opts.index('height') + 1])
+                width = None
+                if 'width' in opts:
+                    width = int(opts[opts.index('width') + 1])
+                elif 'proportional' not in opts:
+                    fail(path, lineno, 'width or proportional is required')
+                packed = 'packed' in opts
+                if packed and width is not None and width > 4:
+                    fail(path, lineno, 'only fonts of width 4 or less can be '
+                         'packed')
+                if packed and width is None and height != 5:
+                    fail(path, lineno, 'only proportional fonts of height 5 '
+                         'can be packed')
+                font = Font(name, height, width, packed)
+                fonts.append(font)
+            elif words[0] == 'glyph':
+                if font is None:
+                    fail(path, lineno, 'glyph before font')
+                code = None if words[1] == 'default' else int(words[1], 0)
+                glyph = (code, comment.strip(), [])
+                font.glyphs.append(glyph)
+            else:
+                if glyph is None:
+                    fail(path, lineno, 'row before glyph')
+                row = words[0]
+                if row == '-':
+                    row = ''
+                if row.strip('#.'):
+                    fail(path, lineno, 'invalid row "{}"'.format(row))
+                glyph[2].append(row)
+    for font in fonts:
+        check(path, font)
+    return fonts
+
+
+def check(path, font):
+    if not font.glyphs or font.glyphs[0][0] is not None:
+        sys.exit('{}: font {}: glyph "default" must come first'.format(
+            path, font.name))
+    if quints(font) and not narrow(font.glyphs[0][2]):
+        sys.exit('{}: font {}: glyph "default" must be 5 dots wide or '
+                 'less'.format(path, font.name))
+    codes = [g[0] for g in font.glyphs[1:]]
+    if codes != sorted(set(codes)) or any(c > 0xff for c in codes):
+        sys.exit('{}: font {}: codes must be unique and ascending'.format(
+            path, font.name))
+    if len(font.glyphs) > 256:
+        sys.exit('{}: font {}: too many glyphs'.format(path, font.name))
+    for code, comment, rows in font.glyphs:
+        widths = set(len(r) for r in rows)
+        if len(rows) != font.height or len(widths) != 1:
+            sys.exit('{}: font {}: glyph {}: bad rows'.format(
+                path, font.name, comment))
+        width = widths.pop()
+        if width > 8 or (font.width is not None and width != font.width):
+            sys.exit('{}: font {}: glyph {}: bad width'.format(
+                path, font.name, comment))
+
+
+def quints(font):
+    # Whether narrow glyphs are packed in 4 bytes
+    return font.packed and font.width is None
+
+
+def narrow(rows):
+    return len(rows[0]) <= 5
+
+
+def order(font):
+    # Glyphs in order of their numbers; narrow glyphs come first in packed
+    # proportional fonts
+    if not quints(font):
+        return list(font.glyphs)
+    return ([g for g in font.glyphs if narrow(g[2])] +
+            [g for g in font.glyphs if not narrow(g[2])])
+
+
+def ranges(font):
+    # Group consecutive codes of consecutive glyph numbers into
+    # { first, last, first glyph } triplets
+    numbers = {id(g): n for n, g in enumerate(order(font))}
+    result = []
+    for glyph in font.glyphs:
+        code = glyph[0]
+        number = numbers[id(glyph)]
+        if code is None:
+            continue
+        if (result and result[-1][1] + 1 == code and
+                result[-1][2] + code - result[-1][0] == number):
+            result[-1][1] = code
+        else:
+            result.append([code, code, number])
+    return result
+
+
+def encode(font, rows):
+    values = [int(r.replace('#', '1').replace('.', '0') or '0', 2)
+              for r in rows]
+    if quints(font) and narrow(rows):
+        data = values[0:4]
+        data[0] |= (values[4] & 0x07) << 5
+        data[1] |= (values[4] >> 3) << 5
+        data[2] |= len(rows[0]) << 5
+        return data
+    if font.packed and font.width is not None:
+        values += [0] * (len(values) % 2)
+        data = [(values[i] << 4) | values[i + 1]
+                for i in range(0, len(values), 2)]
+    else:
+        data = values
+    if font.width is None:
+        data = [len(rows[0])] + data
+    return data
+
+
+def stride(font):
+    if quints(font):
+        return 4
+    lines = (font.height + 1) // 2 if font.packed else font.height
+    return lines + (1 if font.width is None else 0)
+
+
+def wide_stride(font):
+    return font.height + 1
+
+
+def size(font):
+    glyphs = order(font)
+    count = sum(1 for g in glyphs if narrow(g[2])) if quints(font) else \
+        len(glyphs)
+    return (3 * len(ranges(font)) + stride(font) * count +
+            wide_stride(font) * (len(glyphs) - count))
+
+
+def bitmap(font, name, glyphs, first):
+    # Lines of a bitmap table of glyphs numbered from first
+    lines = ['PROGMEM uint8_t const {}[] = {{'.format(name)]
+    entries = []
+    for number, (code, comment, rows) in enumerate(glyphs, first):
+        data = encode(font, rows)
+        label = comment if comment else 'code 0x{:02x}'.format(code)
+        if code is None:
+            label = 'unimplemented character'
+        text = '    // ({:3d}) {}\n    '.format(number, label)
+        if font.width is None and not (quints(font) and narrow(rows)):
+            text += '{}, '.format(data[0])
+            data = data[1:]
+        text += ', '.join('0x{:02x}'.format(v) for v in data)
+        entries.append(text)
+    lines.append(',\n'.join(entries))
+    lines.append('};')
+    return lines
+
+
+def generate(fonts):
+    c = [HEADER.format(name='fonts.c'), '#include <stdint.h>',
+         '#include <avr/pgmspace.h>', '#include "fonts.h"', '']
+    h = [HEADER.format(name='fonts.h'), '#ifndef FONTS_H_',
+         '#define FONTS_H_', '']
+    for font in fonts:
+        lname = font.name.lower()
+        uname = font.name.upper()
+        rs = ranges(font)
+        h.append('// Font "{}"'.format(font.name))
+        h.append('#define FONT_{}_RANGES  {}'.format(uname, len(rs)))
+        h.append('#define FONT_{}_STRIDE  {}'.format(uname, stride(font)))
+        glyphs = order(font)
+        count = len(glyphs)
+        if quints(font):
+            count = sum(1 for g in glyphs if narrow(g[2]))
+            h.append('#define FONT_{}_NARROW  {}'.format(uname, count))
+            h.append('#define FONT_{}_WIDE_STRIDE  {}'.format(
+                uname, wide_stride(font)))
+        h.append('extern uint8_t const font_ranges_{}[];'.format(lname))
+        h.append('extern uint8_t const font_bitmap_{}[];'.format(lname))
+        if quints(font):
+            h.append('extern uint8_t const font_wide_{}[];'.format(lname))
+        h.append('')
+
+        c.append('// Code ranges for font "{}"'.format(font.name))
+        c.append('PROGMEM uint8_t const font_ranges_{}[{}] = {{'.format(
+            lname, 3 * len(rs)))
+        c.append('    // first, last, first glyph')
+        c.append(',\n'.join('    0x{:02x}, 0x{:02x}, {:3d}'.format(*r)
+                            for r in rs))
+        c.append('};')
+        c.append('// Bitmap for font "{}"'.format(font.name))
+        if quints(font):
+            c.append('// (glyphs of width 5 or less in 4 bytes; lines 0..3 in '
+                     'lower 5 bits,')
+            c.append('// line 4 in upper 3 bits of bytes 0..1 and width in '
+                     'those of byte 2)')
+        elif font.width is None:
+            c.append('// (each character has 1 width byte on its head)')
+        elif font.packed:
+            c.append('// (2 lines per byte, upper nibble first)')
+        c += bitmap(font, 'font_bitmap_{}'.format(lname), glyphs[:count], 0)
+        if quints(font):
+            c.append('// Bitmap of wider glyphs for font "{}"'.format(
+                font.name))
+            c.append('// (each character has 1 width byte on its head)')
+            c += bitmap(font, 'font_wide_{}'.format(lname), glyphs[count:],
+                        count)
+        c.append('')
+    h.append('#endif')
+    return '\n'.join(c), '\n'.join(h) + '\n'
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='Compile font sources.')
+    parser.add_argument('-o', '--output', default=os.path.join(
+        here, '..', 'Sources'), help='output directory of fonts.c/fonts.h')
+    parser.add_argument('sources', nargs='*', default=[
+        os.path.join(here, 'fonts', n)
+        for n in ('m0410.txt', 'm0610.txt', 'pp05.txt')])
+    args = parser.parse_args()
+
+    fonts = []
+    for path in args.sources:
+        fonts += parse(path)
+    c, h = generate(fonts)
+    for name, text in (('fonts.c', c), ('fonts.h', h)):
+        with open(os.path.join(args.output, name), 'w',
+                  newline='\r\n') as f:
+            f.write(text)
+    for font in fonts:
+        print('{}: {} glyphs, {} bytes'.format(
+            font.name, len(font.glyphs), size(font)))
+
+
+if __name__ == '__main__':
+    main()
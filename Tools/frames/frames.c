@@ -0,0 +1,389 @@
+/*
+ * DotMatrixClock2018/Tools/frames/frames.c
+ *
+ *  Author: kayekss
+ *  Target: native build
+ *
+ * Golden-frame regression renderer; draws every screen with the firmware's
+ * drawing code, compares the back frame buffer with golden frames in ASCII
+ * art, and times each frame on the host.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <avr/pgmspace.h>
+#include "ctime.h"
+#include "event.h"
+#include "display.h"
+#include "marquee.h"
+#include "drawings.h"
+
+// Frame buffer and clock digits in the firmware
+extern volatile uint32_t fb_back[16];
+extern cdigit_t cd[6];
+
+// Frame case; setup() prepares states kept across frames such as clock
+// ... digits and marquees, draw() draws the frame and is timed repeatedly
+typedef struct {
+    const char* name;
+    void (*setup)();
+    void (*draw)();
+} frame_case_t;
+
+// Fixed inputs of frames
+ctime_t const ct_fixed = { 1, 8, 3, 14, 12, 34, 56, 0 };
+ctime_t const ct_before = { 1, 8, 12, 31, 12, 59, 59, 0 };
+ctime_t const ct_after = { 1, 9, 1, 1, 13, 0, 0, 0 };
+event_t const ev_fixed = { { 7, 30 }, { 22, 5 }, 0x3e };
+ctime_t ct;
+event_t ev;
+marquee_t mq;
+
+// Scroll frame count for the case being set up
+uint8_t scroll_frames;
+
+// -------- Setups --------
+
+void setup_fixed() {
+    ct = ct_fixed;
+    ev = ev_fixed;
+    update_cdigit(&ct);
+}
+
+// Scroll clock digits from 12:59:59 to 13:00:00 by scroll_frames frames
+void setup_scroll() {
+    ct = ct_before;
+    update_cdigit(&ct);
+    ct = ct_after;
+    for (uint8_t i = 0; i < scroll_frames; i++) {
+        update_cdigit_with_scroll(&ct);
+    }
+}
+
+void setup_gps_marquee() {
+    marquee_initialize(&mq, 27, 28, 2, 50);
+    marquee_set_text(&mq, PSTR("Tracking satellites"), true);
+}
+
+void setup_message_short() {
+    marquee_initialize(&mq, 31, 32, 2, 50);
+    marquee_set_text(&mq, "Hello", false);
+}
+
+// Empty message fills no column of the whole-width window
+void setup_message_empty() {
+    marquee_initialize(&mq, 31, 32, 2, 50);
+    marquee_set_text(&mq, "", false);
+}
+
+// Long message scrolled by 20 dots after the head pause
+void setup_message_long() {
+    marquee_initialize(&mq, 31, 32, 2, 50);
+    marquee_set_text(&mq, "The quick brown fox jumps", false);
+    for (uint8_t i = 0; i < 50 + 2 * 20; i++) {
+        marquee_update(&mq);
+    }
+}
+
+#define SETUP_SCROLL(n) \
+    void setup_scroll_##n() { scroll_frames = n; setup_scroll(); }
+SETUP_SCROLL(1) SETUP_SCROLL(2) SETUP_SCROLL(3) SETUP_SCROLL(4)
+SETUP_SCROLL(5) SETUP_SCROLL(6) SETUP_SCROLL(7) SETUP_SCROLL(8)
+SETUP_SCROLL(9) SETUP_SCROLL(10)
+
+// -------- Draws --------
+
+void draw_hm_dow() {
+    draw_time_hm(~0);
+    draw_date_dayofweek(&ct, dayofweek(&ct), ~0);
+}
+
+void draw_hms_year() {
+    draw_time_hms(~0);
+    draw_date_year(&ct, ~0);
+}
+
+void draw_hm() {
+    draw_time_hm(~0);
+}
+
+void draw_hms() {
+    draw_time_hms(~0);
+}
+
+void draw_temperature_positive() {
+    draw_temperature(0, 0, 23, 5625, ~0);
+}
+
+void draw_temperature_negative() {
+    draw_temperature(0, 1, 5, 2500, ~0);
+}
+
+void draw_temperature_error() {
+    draw_temperature(1, 0, 0, 0, ~0);
+}
+
+void draw_gps_absent() {
+    draw_gps_status(0xff, 0, &mq, ~0);
+}
+
+void draw_gps_no_fix() {
+    draw_gps_status(0x00, 3, &mq, ~0);
+}
+
+void draw_gps_fix() {
+    draw_gps_status(0x01, 0, &mq, ~0);
+}
+
+void draw_gps_dgps() {
+    draw_gps_status(0x02, 0, &mq, ~0);
+}
+
+void draw_message_marquee() {
+    draw_message(&mq, ~0);
+}
+
+void draw_use_gps_on() {
+    draw_config_use_gps(true, ~0);
+}
+
+void draw_use_gps_off() {
+    draw_config_use_gps(false, ~0);
+}
+
+void draw_set_time_top() {
+    draw_config_set_time_top(~0);
+}
+
+void draw_set_time_mod() {
+    draw_config_set_time_mod(&ct, dayofweek(&ct), '\203', '\205', ~0);
+}
+
+void draw_set_time_mod_blink() {
+    draw_config_set_time_mod(&ct, dayofweek(&ct), '\203', '\205',
+        ~(1 << 7));
+}
+
+void draw_relay_event_top() {
+    draw_config_relay_event_top(1, 3, ~0);
+}
+
+void draw_relay_event_mod() {
+    draw_config_relay_event_mod(2, &ev, '\200', '\201', ~0);
+}
+
+void draw_relay_event_mask() {
+    draw_config_relay_event_mask(2, &ev, DOW_WEDNESDAY, ~0);
+}
+
+void draw_brightness_8() {
+    draw_config_brightness(8, ~0);
+}
+
+void draw_brightness_15() {
+    draw_config_brightness(15, ~0);
+}
+
+void draw_brightness_auto() {
+    draw_config_brightness(BRIGHTNESS_MAX + 1, ~0);
+}
+
+void draw_save_yes() {
+    draw_config_save_confirm(true, ~0);
+}
+
+void draw_save_no() {
+    draw_config_save_confirm(false, ~0);
+}
+
+void draw_light() {
+    draw_light_adc(512);
+}
+
+// Strings wider than the display are clipped at 32 columns
+void draw_puts_wide_left() {
+    display_puts_P(FONT_PP05, 31, 0, ALIGN_LEFT,
+        PSTR("Wider than the display"));
+}
+
+void draw_puts_wide_center() {
+    display_puts_P(FONT_PP05, 15, 5, ALIGN_CENTER,
+        PSTR("Wider than the display"));
+}
+
+frame_case_t const cases[] = {
+    { "normal_hm_dow", setup_fixed, draw_hm_dow },
+    { "normal_hms_year", setup_fixed, draw_hms_year },
+    { "normal_temperature_positive", setup_fixed, draw_temperature_positive },
+    { "normal_temperature_negative", setup_fixed, draw_temperature_negative },
+    { "normal_temperature_error", setup_fixed, draw_temperature_error },
+    { "normal_gps_absent", setup_gps_marquee, draw_gps_absent },
+    { "normal_gps_no_fix", setup_gps_marquee, draw_gps_no_fix },
+    { "normal_gps_fix", setup_gps_marquee, draw_gps_fix },
+    { "normal_gps_dgps", setup_gps_marquee, draw_gps_dgps },
+    { "normal_message_short", setup_message_short, draw_message_marquee },
+    { "normal_message_long", setup_message_long, draw_message_marquee },
+    { "normal_message_empty", setup_message_empty, draw_message_marquee },
+    { "scroll_hm_01", setup_scroll_1, draw_hm },
+    { "scroll_hm_02", setup_scroll_2, draw_hm },
+    { "scroll_hm_03", setup_scroll_3, draw_hm },
+    { "scroll_hm_04", setup_scroll_4, draw_hm },
+    { "scroll_hm_05", setup_scroll_5, draw_hm },
+    { "scroll_hm_06", setup_scroll_6, draw_hm },
+    { "scroll_hm_07", setup_scroll_7, draw_hm },
+    { "scroll_hm_08", setup_scroll_8, draw_hm },
+    { "scroll_hm_09", setup_scroll_9, draw_hm },
+    { "scroll_hm_10", setup_scroll_10, draw_hm },
+    { "scroll_hms_01", setup_scroll_1, draw_hms },
+    { "scroll_hms_03", setup_scroll_3, draw_hms },
+    { "scroll_hms_05", setup_scroll_5, draw_hms },
+    { "config_use_gps_on", setup_fixed, draw_use_gps_on },
+    { "config_use_gps_off", setup_fixed, draw_use_gps_off },
+    { "config_set_time_top", setup_fixed, draw_set_time_top },
+    { "config_set_time_mod", setup_fixed, draw_set_time_mod },
+    { "config_set_time_mod_blink", setup_fixed, draw_set_time_mod_blink },
+    { "config_relay_event_top", setup_fixed, draw_relay_event_top },
+    { "config_relay_event_mod", setup_fixed, draw_relay_event_mod },
+    { "config_relay_event_mask", setup_fixed, draw_relay_event_mask },
+    { "config_brightness_8", setup_fixed, draw_brightness_8 },
+    { "config_brightness_15", setup_fixed, draw_brightness_15 },
+    { "config_brightness_auto", setup_fixed, draw_brightness_auto },
+    { "config_save_confirm_yes", setup_fixed, draw_save_yes },
+    { "config_save_confirm_no", setup_fixed, draw_save_no },
+    { "misc_light_sensor", setup_fixed, draw_light },
+    { "misc_puts_wide_left", setup_fixed, draw_puts_wide_left },
+    { "misc_puts_wide_center", setup_fixed, draw_puts_wide_center }
+};
+#define CASE_COUNT  (sizeof(cases) / sizeof(cases[0]))
+
+// -------- Frames --------
+
+// Format back frame buffer in ASCII art; 16 lines of 32 columns
+void format_frame(char* text) {
+    for (uint8_t y = 0; y < 16; y++) {
+        for (uint8_t x = 0; x < 32; x++) {
+            *text++ = fb_back[y] & (1ul << (31 - x)) ? '#' : '.';
+        }
+        *text++ = '\n';
+    }
+    *text = '\0';
+}
+
+// Print golden and actual frames side by side, marking differing lines
+void print_diff(const char* golden, const char* actual) {
+    printf("  %-32s   %-32s\n", "golden", "actual");
+    for (uint8_t y = 0; y < 16; y++) {
+        bool same = strncmp(golden + 33 * y, actual + 33 * y, 32) == 0;
+        printf("%c %.32s   %.32s\n", same ? ' ' : '>', golden + 33 * y,
+            actual + 33 * y);
+    }
+}
+
+// Get nanoseconds per draw, repeated until 10 ms elapses
+double time_draw(frame_case_t const* c) {
+    struct timespec t0, t1;
+    uint32_t n = 0;
+    double elapsed;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    do {
+        for (uint16_t i = 0; i < 100; i++) {
+            display_clear();
+            c->draw();
+        }
+        n += 100;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        elapsed = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+    } while (elapsed < 1e7);
+    return elapsed / n;
+}
+
+void usage(const char* name) {
+    fprintf(stderr, "usage: %s [-u] [-t] [-g GOLDEN_DIR] [CASE...]\n"
+        "  -u  update golden frames instead of comparing\n"
+        "  -t  time each frame on the host\n"
+        "  -g  directory of golden frames (default golden)\n", name);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    const char* dir = "golden";
+    bool update = false;
+    bool timing = false;
+    char actual[33 * 16 + 1];
+    char golden[33 * 16 + 1];
+    char path[256];
+    unsigned failures = 0;
+    size_t n;
+    FILE* f;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "utg:")) != -1) {
+        switch (opt) {
+        case 'u':
+            update = true;
+            break;
+        case 't':
+            timing = true;
+            break;
+        case 'g':
+            dir = optarg;
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    for (unsigned i = 0; i < CASE_COUNT; i++) {
+        frame_case_t const* c = &cases[i];
+        bool selected = optind == argc;
+
+        for (int j = optind; j < argc; j++) {
+            selected |= strcmp(argv[j], c->name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        c->setup();
+        display_clear();
+        c->draw();
+        format_frame(actual);
+        snprintf(path, sizeof(path), "%s/%s.txt", dir, c->name);
+        if (update) {
+            f = fopen(path, "w");
+            if (!f) {
+                perror(path);
+                return 2;
+            }
+            fputs(actual, f);
+            fclose(f);
+        } else {
+            f = fopen(path, "r");
+            n = f ? fread(golden, 1, sizeof(golden) - 1, f) : 0;
+            golden[n] = '\0';
+            if (f) {
+                fclose(f);
+            }
+            if (strcmp(golden, actual) != 0) {
+                printf("FAIL %s\n", c->name);
+                if (n == sizeof(golden) - 1) {
+                    print_diff(golden, actual);
+                } else {
+                    printf("  golden frame is missing or malformed\n");
+                }
+                failures++;
+            }
+        }
+        if (timing) {
+            printf("%-32s %8.1f ns\n", c->name, time_draw(c));
+        }
+    }
+    if (failures) {
+        printf("%u of %u frames differ\n", failures, (unsigned) CASE_COUNT);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * DotMatrixClock2018/Tools/sim/eeprom_model.c
+ *
+ *  Author: kayekss
+ *  Target: native build (simulator)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "eeprom.h"
+#include "sim.h"
+
+// EEPROM cells; erased cells read ones
+uint8_t eeprom_cells[EEPROM_ADDRESS_MASK + 1];
+
+// Load EEPROM image if it exists, otherwise start from erased cells
+void eeprom_model_load(const char* path) {
+    FILE* f = path ? fopen(path, "rb") : NULL;
+
+    memset(eeprom_cells, 0xff, sizeof(eeprom_cells));
+    if (f) {
+        if (fread(eeprom_cells, 1, sizeof(eeprom_cells), f) !=
+            sizeof(eeprom_cells)) {
+            fprintf(stderr, "%s: short EEPROM image\n", path);
+        }
+        fclose(f);
+    }
+}
+
+// Save EEPROM image
+void eeprom_model_save(const char* path) {
+    FILE* f = fopen(path, "wb");
+
+    if (!f) {
+        perror(path);
+        return;
+    }
+    fwrite(eeprom_cells, 1, sizeof(eeprom_cells), f);
+    fclose(f);
+}
+
+// -------- EEPROM driver --------
+
+uint8_t eeprom_read(uint16_t addr) {
+    return eeprom_cells[addr & EEPROM_ADDRESS_MASK];
+}
+
+uint8_t eeprom_verify(uint16_t addr, uint8_t d) {
+    if (addr & ~EEPROM_ADDRESS_MASK) {
+        return ~0;
+    }
+    return eeprom_read(addr) ^ d;
+}
+
+// Write a byte; write-only mode can only clear bits as the device does.
+// ... The driver waits for programming, 3.4 ms with erase and 1.8 ms
+// ... without, with interrupts enabled
+void eeprom_write(uint16_t addr, uint8_t d, bool erase) {
+    uint8_t* cell = &eeprom_cells[addr & EEPROM_ADDRESS_MASK];
+
+    *cell = erase ? d : *cell & d;
+    sim_busy((uint64_t) (F_CPU / 10000) * (erase ? 34 : 18));
+}
+
+void eeprom_update(uint16_t addr, uint8_t d) {
+    uint8_t r = eeprom_read(addr);
+
+    if (r != d) {
+        eeprom_write(addr, d, (~r & d) != 0);
+    }
+}
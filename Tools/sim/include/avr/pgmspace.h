@@ -0,0 +1,23 @@
+/*
+ * DotMatrixClock2018/Tools/sim/include/avr/pgmspace.h
+ *
+ *  Author: kayekss
+ *  Target: native build (simulator)
+ */
+
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// Program memory is ordinary memory on native builds
+#define PROGMEM
+#define PSTR(s)  (s)
+#define pgm_read_byte(p)  (*(const uint8_t*) (p))
+#define pgm_read_word(p)  (*(const uint16_t*) (p))
+#define pgm_read_dword(p)  (*(const uint32_t*) (p))
+#define strcpy_P(d, s)  strcpy((d), (s))
+#define memcpy_P(d, s, n)  memcpy((d), (s), (n))
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * DotMatrixClock2018/Tools/sim/panel.c
+ *
+ *  Author: kayekss
+ *  Target: native build (simulator)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "display.h"
+#include "sim.h"
+
+// Scan line planes and display brightness in the firmware
+extern volatile scanline_t scan_planes[2][16];
+extern volatile scanline_t* volatile scan_front;
+extern volatile bool scan_swap_pending;
+extern volatile uint8_t display_brightness;
+
+// LED panel model
+struct {
+    // Lines shown in the last frame; bit 31 is the leftmost column
+    uint32_t lines[16];
+    // Brightness level of the last frame
+    uint8_t brightness;
+    // Frame count
+    uint64_t frames;
+    // Frame printed last
+    uint32_t printed_lines[16];
+    uint8_t printed_brightness;
+    bool printed;
+} panel;
+
+// Decode a serialized line into dots;
+// ... data on the clock with the line bit set belongs to that line
+uint32_t panel_decode_line(volatile scanline_t* sp, uint8_t y) {
+    uint32_t b = 0;
+
+    if (sp->blank) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < 16; i++) {
+        if (sp->data[i] & SCAN_BIT_LEFT) {
+            b |= 1ul << (16 + i);
+        }
+        if (sp->data[i] & SCAN_BIT_RIGHT) {
+            b |= 1ul << i;
+        }
+    }
+    // Dots are not lit unless the line driver is selected
+    if (!(sp->data[y] & SCAN_BIT_LINE)) {
+        if (b) {
+            fprintf(stderr, "sim: line %u is not selected at ", y);
+            sim_print_time(stderr);
+            fprintf(stderr, " s\n");
+        }
+        return 0;
+    }
+    return b;
+}
+
+// Scan a frame at the frame boundary of display ISR
+void panel_frame() {
+    bool changed;
+
+    // Flip scan line planes as the display ISR does
+    if (scan_swap_pending) {
+        scan_front = scan_front == scan_planes[0] ?
+            scan_planes[1] : scan_planes[0];
+        scan_swap_pending = false;
+    }
+    for (uint8_t y = 0; y < 16; y++) {
+        panel.lines[y] = panel_decode_line(&scan_front[y], y);
+    }
+    panel.brightness = display_brightness;
+    panel.frames++;
+    if (sim_config.print_frames) {
+        changed = !panel.printed ||
+            panel.brightness != panel.printed_brightness ||
+            memcmp(panel.lines, panel.printed_lines, sizeof(panel.lines));
+        if (changed) {
+            panel_print(stdout);
+        }
+    }
+}
+
+// Print the last frame; dots are shown regardless of brightness
+void panel_print(FILE* f) {
+    fprintf(f, "[");
+    sim_print_time(f);
+    fprintf(f, "] frame %llu, brightness %u/%u\n",
+        (unsigned long long) panel.frames, panel.brightness, BRIGHTNESS_MAX);
+    for (uint8_t y = 0; y < 16; y++) {
+        for (uint8_t x = 0; x < 32; x++) {
+            fputc(panel.lines[y] & (1ul << (31 - x)) ? '#' : '.', f);
+        }
+        fputc('\n', f);
+    }
+    memcpy(panel.printed_lines, panel.lines, sizeof(panel.lines));
+    panel.printed_brightness = panel.brightness;
+    panel.printed = true;
+}
+
+// Get frame count
+uint64_t panel_frames() {
+    return panel.frames;
+}
@@ -0,0 +1,450 @@
+/*
+ * DotMatrixClock2018/Tools/sim/sim.c
+ *
+ *  Author: kayekss
+ *  Target: native build (simulator)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "hal.h"
+#include "adc.h"
+#include "display.h"
+#include "timebase.h"
+#include "usart.h"
+#include "sim.h"
+
+// Firmware entry point, renamed by the build
+int firmware_main(void);
+
+// USART receiver buffer and errors of the firmware
+extern ringbuf_t rx;
+extern volatile usart_errors_t usart_errors;
+
+// Event periods in CPU cycles;
+// ... Timer1 compare match, display frame of 16 lines in 15 BCM units each,
+// ... and a USART frame of 10 bits at a baud rate
+#define TICK_CYCLES   (F_CPU / 1000)
+#define FRAME_CYCLES  (16ull * (2 * BCM_MAX_WEIGHT - 1) * BCM_UNIT_COUNTS * 64)
+#define BYTE_CYCLES(baud)  (F_CPU * 10 / (baud))
+
+// Key press entries from key script
+#define KEY_ENTRIES_MAX  256
+
+// Virtual clock
+uint64_t sim_cycles = 0;
+
+// Simulation parameters
+sim_config_t sim_config = {
+    10000, false, 512, 25 * 16, 2018, 1, 1, 0, 0, 0, NULL, 9600
+};
+
+// States of peripheral models and event sources
+struct {
+    // Global interrupt enable
+    bool interrupts;
+    // Cycles of next Timer1 compare match and display frame (0: stopped)
+    uint64_t next_tick;
+    uint64_t next_frame;
+    // Serial input bytes and index of the next byte to receive
+    uint8_t* rx_data;
+    size_t rx_length;
+    size_t rx_pos;
+    // Cycles of next reception (0: no more bytes or receiver disabled)
+    uint64_t next_rx;
+    // Byte currently in receive data register, and its receiver errors
+    uint8_t rx_byte;
+    uint8_t rx_errors;
+    // Baud rate set by the firmware
+    uint32_t baud;
+    // Whether the data register empty interrupt is enabled
+    bool tx_enabled;
+    // Cycles when the transmitter gets ready for the next byte
+    uint64_t tx_ready;
+    // Key press entries in milliseconds
+    struct {
+        uint64_t start;
+        uint64_t end;
+        uint8_t key;
+    } keys[KEY_ENTRIES_MAX];
+    uint16_t key_count;
+    // Relay outputs written last
+    uint8_t relays;
+    // Host processor time on startup
+    clock_t started;
+} sim_io;
+
+// Print virtual time
+void sim_print_time(FILE* f) {
+    uint64_t ms = SIM_MS(sim_cycles);
+
+    fprintf(f, "%llu.%03llu", (unsigned long long) (ms / 1000),
+        (unsigned long long) (ms % 1000));
+}
+
+// Stop simulation and print results
+void sim_finish() {
+    double host = (double) (clock() - sim_io.started) / CLOCKS_PER_SEC;
+
+    panel_print(stdout);
+    if (sim_config.eeprom_path) {
+        eeprom_model_save(sim_config.eeprom_path);
+    }
+    fprintf(stderr, "sim: ");
+    sim_print_time(stderr);
+    fprintf(stderr, " s virtual in %.3f s host, %llu frames, relays %u%u%u\n",
+        host, (unsigned long long) panel_frames(),
+        sim_io.relays & 0x01, (sim_io.relays >> 1) & 0x01,
+        (sim_io.relays >> 2) & 0x01);
+    fprintf(stderr, "sim: rx overruns %u, data overruns %u, frame errors %u\n",
+        rx.overruns, usart_errors.data_overruns, usart_errors.frame_errors);
+    exit(0);
+}
+
+// Schedule the next received byte not earlier than specified cycles;
+// ... a line "@MS" in serial input holds the following bytes until
+// ... virtual time MS milliseconds, and is not sent itself
+void sim_schedule_rx(uint64_t earliest) {
+    char* end = NULL;
+    uint64_t hold;
+
+    while (sim_io.rx_pos < sim_io.rx_length &&
+        sim_io.rx_data[sim_io.rx_pos] == '@' &&
+        (sim_io.rx_pos == 0 || sim_io.rx_data[sim_io.rx_pos - 1] == '\n')) {
+        hold = strtoull((char*) &sim_io.rx_data[sim_io.rx_pos + 1], &end, 10);
+        hold *= F_CPU / 1000;
+        if (hold > earliest) {
+            earliest = hold;
+        }
+        sim_io.rx_pos = (uint8_t*) end - sim_io.rx_data;
+        while (sim_io.rx_pos < sim_io.rx_length &&
+            sim_io.rx_data[sim_io.rx_pos++] != '\n');
+    }
+    sim_io.next_rx = sim_io.rx_pos < sim_io.rx_length ? earliest : 0;
+}
+
+// -------- Hardware abstraction layer --------
+
+void setup_eeprom() {
+}
+
+void setup_power() {
+}
+
+void setup_io() {
+}
+
+void setup_timer0() {
+    sim_io.next_frame = sim_cycles + FRAME_CYCLES;
+}
+
+void setup_timer1() {
+    sim_io.next_tick = sim_cycles + TICK_CYCLES;
+}
+
+void setup_usart0() {
+    sim_io.baud = 9600;
+    sim_schedule_rx(sim_cycles + BYTE_CYCLES(sim_config.line_baud));
+}
+
+void setup_twi() {
+}
+
+void setup_adc() {
+}
+
+// Get input levels of keys from key script; keys are low-active
+uint8_t hal_read_keys() {
+    uint64_t ms = SIM_MS(sim_cycles);
+    uint8_t levels = 0x03;
+
+    for (uint16_t i = 0; i < sim_io.key_count; i++) {
+        if (ms >= sim_io.keys[i].start && ms < sim_io.keys[i].end) {
+            levels &= ~(1 << sim_io.keys[i].key);
+        }
+    }
+    return levels;
+}
+
+void hal_write_relays(uint8_t port) {
+    if (port != sim_io.relays) {
+        printf("[");
+        sim_print_time(stdout);
+        printf("] relays %u%u%u\n", port & 0x01, (port >> 1) & 0x01,
+            (port >> 2) & 0x01);
+    }
+    sim_io.relays = port;
+}
+
+// Bytes are always taken in time; they are framed right unless sent at
+// ... another rate than set
+uint8_t hal_usart_rx_errors() {
+    return sim_io.rx_errors;
+}
+
+// Rates are taken as exact, though the target rounds them
+void hal_usart_set_baud(uint32_t baud) {
+    sim_io.baud = baud;
+}
+
+uint8_t hal_usart_receive() {
+    return sim_io.rx_byte;
+}
+
+// Print transmitted byte; carriage returns are omitted
+void hal_usart_transmit(uint8_t d) {
+    if (d != '\r') {
+        putchar(d);
+    }
+    sim_io.tx_ready = sim_cycles + BYTE_CYCLES(sim_io.baud);
+}
+
+void hal_usart_start_tx() {
+    sim_io.tx_enabled = true;
+}
+
+void hal_usart_stop_tx() {
+    sim_io.tx_enabled = false;
+}
+
+uint16_t hal_timer1_count() {
+    return sim_io.next_tick ?
+        TICK_CYCLES - (sim_io.next_tick - sim_cycles) : 0;
+}
+
+void hal_enable_interrupts() {
+    sim_io.interrupts = true;
+}
+
+void hal_disable_interrupts() {
+    sim_io.interrupts = false;
+}
+
+// Advance virtual time to the next event, not beyond a limit, and call
+// ... its interrupt handler
+void sim_advance(uint64_t limit) {
+    uint64_t end = sim_config.duration_ms * (F_CPU / 1000);
+    uint64_t next = end < limit ? end : limit;
+
+    if (!sim_io.interrupts) {
+        fprintf(stderr, "sim: waiting with interrupts disabled at ");
+        sim_print_time(stderr);
+        fprintf(stderr, " s\n");
+        exit(1);
+    }
+    // Find the earliest event
+    if (sim_io.next_tick && sim_io.next_tick < next) {
+        next = sim_io.next_tick;
+    }
+    if (sim_io.next_frame && sim_io.next_frame < next) {
+        next = sim_io.next_frame;
+    }
+    if (sim_io.next_rx && sim_io.next_rx < next) {
+        next = sim_io.next_rx;
+    }
+    if (twi_next && twi_next < next) {
+        next = twi_next;
+    }
+    if (sim_io.tx_enabled) {
+        if (sim_io.tx_ready < sim_cycles) {
+            sim_io.tx_ready = sim_cycles;
+        }
+        if (sim_io.tx_ready < next) {
+            next = sim_io.tx_ready;
+        }
+    }
+    sim_cycles = next;
+    if (sim_cycles >= end) {
+        sim_finish();
+    }
+    // Dispatch events due in order of interrupt vector priority
+    if (sim_io.next_tick == sim_cycles) {
+        sim_io.next_tick += TICK_CYCLES;
+#ifdef SINGLE_TIMER_ISR
+        // Called by the display ISR on target, which is not modeled;
+        // ... ticks are kept on the exact millisecond
+        tick_isr();
+#else
+        TIMER1_COMPA_vect();
+#endif
+    }
+    if (sim_io.next_frame == sim_cycles) {
+        sim_io.next_frame += FRAME_CYCLES;
+        panel_frame();
+    }
+    if (sim_io.next_rx == sim_cycles) {
+        sim_io.rx_byte = sim_io.rx_data[sim_io.rx_pos++];
+        sim_io.rx_errors = 0;
+        // Bytes sent at another rate are taken broken, as a crude model,
+        // ... with frame errors on every other one
+        if (sim_io.baud != sim_config.line_baud) {
+            sim_io.rx_byte ^= 0xff;
+            if (sim_io.rx_pos & 1) {
+                sim_io.rx_errors = HAL_USART_FRAME_ERROR;
+            }
+        }
+        sim_schedule_rx(sim_cycles + BYTE_CYCLES(sim_config.line_baud));
+        USART_RX_vect();
+    }
+    if (sim_io.tx_enabled && sim_io.tx_ready == sim_cycles) {
+        USART_UDRE_vect();
+    }
+    if (twi_next == sim_cycles) {
+        TWI_vect();
+    }
+}
+
+// Advance virtual time to the next event; the firmware itself takes no
+// ... virtual time. Called with interrupts disabled, and enables them as
+// ... the target does; a call with them enabled may miss a wakeup there
+void hal_idle() {
+    if (sim_io.interrupts) {
+        fprintf(stderr, "sim: idling with interrupts enabled at ");
+        sim_print_time(stderr);
+        fprintf(stderr, " s\n");
+        exit(1);
+    }
+    sim_io.interrupts = true;
+    sim_advance(UINT64_MAX);
+}
+
+// Let virtual time pass in a busy loop of the firmware, such as a wait
+// ... for EEPROM programming, with interrupts taken meanwhile
+void sim_busy(uint64_t cycles) {
+    uint64_t until = sim_cycles + cycles;
+
+    while (sim_cycles < until) {
+        sim_advance(until);
+    }
+}
+
+// -------- Peripheral models without TWI --------
+
+// Read light sensor on channel 2; other channels read zero
+uint16_t read_adc(uint8_t adcsel) {
+    return adcsel == 2 ? sim_config.light_adc & 0x03ff : 0;
+}
+
+// -------- Command line --------
+
+// Load serial input bytes
+void load_serial_input(const char* path) {
+    FILE* f = fopen(path, "rb");
+    size_t n;
+
+    if (!f) {
+        perror(path);
+        exit(2);
+    }
+    while (!feof(f)) {
+        sim_io.rx_data = realloc(sim_io.rx_data, sim_io.rx_length + 4096);
+        n = fread(sim_io.rx_data + sim_io.rx_length, 1, 4096, f);
+        sim_io.rx_length += n;
+    }
+    // Terminate for parsing of hold lines
+    sim_io.rx_data[sim_io.rx_length] = '\0';
+    fclose(f);
+}
+
+// Load key script; each line is "START_MS KEY DURATION_MS"
+void load_key_script(const char* path) {
+    FILE* f = fopen(path, "r");
+    char line[128];
+    unsigned long long start, duration;
+    unsigned key;
+
+    if (!f) {
+        perror(path);
+        exit(2);
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%llu %u %llu", &start, &key, &duration) != 3 ||
+            key > 1) {
+            continue;
+        }
+        if (sim_io.key_count == KEY_ENTRIES_MAX) {
+            fprintf(stderr, "%s: too many entries\n", path);
+            exit(2);
+        }
+        sim_io.keys[sim_io.key_count].start = start;
+        sim_io.keys[sim_io.key_count].end = start + duration;
+        sim_io.keys[sim_io.key_count].key = key;
+        sim_io.key_count++;
+    }
+    fclose(f);
+}
+
+void usage(const char* name) {
+    fprintf(stderr,
+        "usage: %s [-t SECONDS] [-f] [-a ADC] [-c CELSIUS]\n"
+        "    [-s 'YYYY-MM-DD hh:mm:ss'] [-e EEPROM_FILE] [-r SERIAL_INPUT]\n"
+        "    [-k KEY_SCRIPT] [-b BAUD] [-w MS]\n"
+        "  -t  virtual time to run (default 10)\n"
+        "  -f  print every changed frame\n"
+        "  -a  light sensor ADC value, 0..1023 (default 512)\n"
+        "  -c  ambient temperature (default 25.0)\n"
+        "  -s  RTC time on startup (default 2018-01-01 00:00:00)\n"
+        "  -e  EEPROM image to load and save\n"
+        "  -r  serial input; a line '@MS' holds the rest until MS\n"
+        "  -k  key script; lines of 'START_MS KEY DURATION_MS'\n"
+        "  -b  baud rate of serial input (default 9600)\n"
+        "  -w  start ticks MS milliseconds before their 32-bit wrap\n", name);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:fa:c:s:e:r:k:b:w:h")) != -1) {
+        switch (opt) {
+        case 't':
+            sim_config.duration_ms = (uint64_t) (atof(optarg) * 1000);
+            break;
+        case 'f':
+            sim_config.print_frames = true;
+            break;
+        case 'a':
+            sim_config.light_adc = atoi(optarg);
+            break;
+        case 'c':
+            sim_config.temperature_x16 = (int16_t) (atof(optarg) * 16);
+            break;
+        case 's':
+            if (sscanf(optarg, "%d-%d-%d %d:%d:%d", &sim_config.year,
+                &sim_config.month, &sim_config.day, &sim_config.hour,
+                &sim_config.minute, &sim_config.second) != 6) {
+                usage(argv[0]);
+            }
+            break;
+        case 'e':
+            sim_config.eeprom_path = optarg;
+            break;
+        case 'r':
+            load_serial_input(optarg);
+            break;
+        case 'k':
+            load_key_script(optarg);
+            break;
+        case 'b':
+            sim_config.line_baud = strtoul(optarg, NULL, 10);
+            if (sim_config.line_baud == 0) {
+                usage(argv[0]);
+            }
+            break;
+        case 'w':
+            ticks = 0 - (uint32_t) strtoul(optarg, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    twi_models_initialize();
+    eeprom_model_load(sim_config.eeprom_path);
+    sim_io.started = clock();
+    return firmware_main();
+}
@@ -0,0 +1,55 @@
+/*
+ * DotMatrixClock2018/Tools/sim/sim.h
+ *
+ *  Author: kayekss
+ *  Target: native build (simulator)
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Virtual clock in CPU cycles of F_CPU
+extern uint64_t sim_cycles;
+
+// Simulation parameters given by command line
+typedef struct {
+    // Virtual time to run in milliseconds
+    uint64_t duration_ms;
+    // Print every changed frame, not only the last one
+    bool print_frames;
+    // Light sensor ADC value (0..1023)
+    uint16_t light_adc;
+    // Ambient temperature in 1/16 degrees Celsius
+    int16_t temperature_x16;
+    // RTC time on startup
+    int year, month, day, hour, minute, second;
+    // EEPROM image file, or NULL
+    const char* eeprom_path;
+    // Baud rate of serial input
+    uint32_t line_baud;
+} sim_config_t;
+
+extern sim_config_t sim_config;
+
+// Virtual time in milliseconds
+#define SIM_MS(cycles)  ((cycles) / (F_CPU / 1000))
+
+void sim_print_time(FILE* f);
+void sim_busy(uint64_t cycles);
+
+void panel_frame();
+void panel_print(FILE* f);
+uint64_t panel_frames();
+
+// Cycles when the running TWI transaction completes (0: bus idle)
+extern uint64_t twi_next;
+
+void twi_models_initialize();
+void eeprom_model_load(const char* path);
+void eeprom_model_save(const char* path);
+
+#endif
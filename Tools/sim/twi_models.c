@@ -0,0 +1,251 @@
+/*
+ * DotMatrixClock2018/Tools/sim/twi_models.c
+ *
+ *  Author: kayekss
+ *  Target: native build (simulator)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "hal.h"
+#include "twi.h"
+#include "trace.h"
+#include "ctime.h"
+#include "rtc_ds1307.h"
+#include "temp_adt7410.h"
+#include "sim.h"
+
+// TWI bus in master mode
+struct {
+    // Addressed slave (0: none)
+    uint8_t addr7;
+    // Whether the slave is addressed to read
+    bool read;
+    // Whether the next byte written is the register pointer
+    bool pointer_next;
+} twi_bus;
+
+// DS1307 real-time clock
+struct {
+    // Registers; clock registers are BCD coded, SRAM follows
+    uint8_t reg[64];
+    uint8_t pointer;
+    // Virtual time of the last clock update
+    uint64_t updated;
+} ds1307;
+
+// ADT7410 temperature sensor
+struct {
+    uint8_t reg[0x30];
+    uint8_t pointer;
+} adt7410;
+
+// Get days in the month
+uint8_t rtc_days_in_month(uint16_t year, uint8_t month) {
+    static uint8_t const days[12] = {
+        31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+    };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+// Increment a BCD coded register; return true on carry to the next one
+bool bcd_increment(uint8_t* r, uint8_t first, uint8_t last) {
+    uint8_t n = 10 * (*r >> 4) + (*r & 0x0f);
+    bool carry = n >= last;
+
+    n = carry ? first : n + 1;
+    *r = ((n / 10) << 4) | (n % 10);
+    return carry;
+}
+
+// Advance DS1307 clock by a second; 24-hour mode only
+void ds1307_tick() {
+    uint8_t* r = ds1307.reg;
+    uint8_t year = 10 * (r[6] >> 4) + (r[6] & 0x0f);
+    uint8_t month = 10 * (r[5] >> 4) + (r[5] & 0x0f);
+
+    if (!bcd_increment(&r[0], 0, 59)) return;
+    if (!bcd_increment(&r[1], 0, 59)) return;
+    if (!bcd_increment(&r[2], 0, 23)) return;
+    r[3] = r[3] >= 7 ? 1 : r[3] + 1;
+    if (!bcd_increment(&r[4], 1, rtc_days_in_month(2000 + year, month))) return;
+    if (!bcd_increment(&r[5], 1, 12)) return;
+    bcd_increment(&r[6], 0, 99);
+}
+
+// Catch up DS1307 clock with virtual time unless clock halt bit is set
+void ds1307_update() {
+    while (sim_cycles - ds1307.updated >= F_CPU) {
+        ds1307.updated += F_CPU;
+        if (!(ds1307.reg[0] & 0x80)) {
+            ds1307_tick();
+        }
+    }
+}
+
+// Get a byte to be read from the addressed slave
+uint8_t twi_slave_read() {
+    int16_t t;
+
+    if (twi_bus.addr7 == ADDR7_DS1307) {
+        return ds1307.reg[ds1307.pointer++ & 0x3f];
+    } else {
+        // Temperature in 13-bit resolution, flags in LSB are left zero
+        t = sim_config.temperature_x16 * 8;
+        adt7410.reg[REG_ADT7410_VALUE_MSB] = (uint16_t) t >> 8;
+        adt7410.reg[REG_ADT7410_VALUE_LSB] = (uint16_t) t & 0xf8;
+        return adt7410.reg[adt7410.pointer++ % sizeof(adt7410.reg)];
+    }
+}
+
+// Write a byte to the addressed slave
+void twi_slave_write(uint8_t data) {
+    if (twi_bus.addr7 == ADDR7_DS1307) {
+        if (twi_bus.pointer_next) {
+            ds1307.pointer = data;
+        } else {
+            if ((ds1307.pointer & 0x3f) == REG_DS1307_SECONDS) {
+                // Writing seconds restarts the countdown chain
+                ds1307.updated = sim_cycles;
+            }
+            ds1307.reg[ds1307.pointer++ & 0x3f] = data;
+        }
+    } else {
+        if (twi_bus.pointer_next) {
+            adt7410.pointer = data;
+        } else {
+            adt7410.reg[adt7410.pointer++ % sizeof(adt7410.reg)] = data;
+        }
+    }
+    twi_bus.pointer_next = false;
+}
+
+// Setup slaves with the simulation parameters
+void twi_models_initialize() {
+    uint8_t values[7] = {
+        sim_config.second, sim_config.minute, sim_config.hour, 1,
+        sim_config.day, sim_config.month, sim_config.year % 100
+    };
+
+    for (uint8_t i = 0; i < 7; i++) {
+        ds1307.reg[i] = ((values[i] / 10) << 4) | (values[i] % 10);
+    }
+    ds1307.reg[REG_DS1307_CONTROL] = 0x03;
+    adt7410.reg[REG_ADT7410_ID] = 0xcb;
+}
+
+// -------- TWI driver --------
+
+// Bus time of a transaction in cycles at 100 kHz; 9 bits per byte and
+// ... about a bit per start and stop condition
+#define TWI_BIT_CYCLES  (F_CPU / 100000)
+
+// Queue of transactions; the first one is running until twi_next
+twi_xfer_t* twi_head = NULL;
+twi_xfer_t* twi_tail = NULL;
+uint64_t twi_next = 0;
+// Whether a callback is running; the bus is started after it returns
+bool twi_finishing = false;
+
+// Start the transaction at the head of the queue
+void twi_start_head() {
+    twi_xfer_t* x = twi_head;
+    uint16_t bits = 2 + 9 * (1 + x->tx_length);
+
+    trace_event_isr(TRACE_TWI_START, (x->addr7 << 1) | !x->tx_length);
+    if (x->rx_length) {
+        bits += 1 + 9 * (1 + x->rx_length);
+    }
+    twi_next = sim_cycles + (uint64_t) bits * TWI_BIT_CYCLES;
+}
+
+void twi_submit_isr(twi_xfer_t* x) {
+    x->status = TWI_BUSY;
+    x->next = NULL;
+    if (twi_head) {
+        twi_tail->next = x;
+        twi_tail = x;
+    } else {
+        twi_head = twi_tail = x;
+        if (!twi_finishing) {
+            twi_start_head();
+        }
+    }
+}
+
+void twi_submit(twi_xfer_t* x) {
+    hal_disable_interrupts();
+    twi_submit_isr(x);
+    hal_enable_interrupts();
+}
+
+uint8_t twi_wait(twi_xfer_t* x) {
+    hal_disable_interrupts();
+    while (x->status == TWI_BUSY) {
+        hal_idle();
+        hal_disable_interrupts();
+    }
+    hal_enable_interrupts();
+    return x->status != TWI_OK;
+}
+
+uint8_t twi_transfer(twi_xfer_t* x) {
+    twi_submit(x);
+    return twi_wait(x);
+}
+
+// Address a slave; return false on NACK from absent slaves
+bool twi_address(uint8_t addr7, bool read) {
+    twi_bus.addr7 = addr7;
+    twi_bus.read = read;
+    twi_bus.pointer_next = !read;
+    if (addr7 == ADDR7_DS1307) {
+        ds1307_update();
+    } else if (addr7 != ADDR7_ADT7410) {
+        twi_bus.addr7 = 0;
+        return false;
+    }
+    return true;
+}
+
+// Run the transaction at the head of the queue on the slaves at once when
+// ... its bus time is over, and go on to the next one
+ISR(TWI_vect) {
+    twi_xfer_t* x = twi_head;
+    bool ok = true;
+
+    if (x->tx_length) {
+        ok = twi_address(x->addr7, false);
+        for (uint8_t i = 0; ok && i < x->tx_length; i++) {
+            twi_slave_write(x->tx[i]);
+        }
+    }
+    if (ok && x->rx_length) {
+        if (x->tx_length) {
+            // Repeated start, traced at the end of the transaction
+            trace_event_isr(TRACE_TWI_START, (x->addr7 << 1) | 0x01);
+        }
+        ok = twi_address(x->addr7, true);
+        for (uint8_t i = 0; ok && i < x->rx_length; i++) {
+            x->rx[i] = twi_slave_read();
+        }
+    }
+    trace_event_isr(TRACE_TWI_STOP, 0);
+    twi_bus.addr7 = 0;
+    x->status = ok ? TWI_OK : TWI_ERROR;
+    // Dequeue before the callback, as the firmware does
+    twi_head = x->next;
+    if (x->done) {
+        twi_finishing = true;
+        x->done(x);
+        twi_finishing = false;
+    }
+    if (twi_head) {
+        twi_start_head();
+    } else {
+        twi_next = 0;
+    }
+}
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+#
+# DotMatrixClock2018/Tools/trace/tracedec.py
+#
+#  Author: kayekss
+#
+# Decodes "T" lines of a firmware built with TRACE from a serial capture
+# into a Chrome trace JSON, to be opened in Perfetto UI or chrome://tracing.
+# Task names are taken from task_id_t in Sources/sched.h; give the same -D
+# options as the firmware was built with, as some tasks are optional.
+#
+# Usage: tracedec.py [-D MACRO]... [-o TRACE_JSON] [CAPTURE]
+
+import argparse
+import json
+import os
+import re
+import sys
+
+# CPU cycles per microsecond
+CYCLES_PER_US = 20
+
+# Event kinds, as trace_event_t in Sources/trace.h
+EVENTS = ('lost', 'task_begin', 'task_end', 'timer0', 'timer1',
+          'usart_rx', 'usart_udre', 'state', 'twi_start', 'twi_stop',
+          'overflow')
+BUFFERS = ('RX', 'USART')
+
+# Tracks of the timeline
+TRACKS = {'task': 1, 'isr': 2, 'twi': 3, 'state': 4, 'trace': 5}
+
+SCHED_H = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                       '..', '..', 'Sources', 'sched.h')
+
+
+def task_names(path, defines):
+    # Enumerators of task_id_t, honoring #ifdef blocks
+    names = []
+    enabled = [True]
+    in_enum = False
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('typedef enum'):
+                in_enum = True
+            elif not in_enum:
+                continue
+            elif line.startswith('#ifdef'):
+                enabled.append(enabled[-1] and line.split()[1] in defines)
+            elif line.startswith('#endif'):
+                enabled.pop()
+            elif line.startswith('}'):
+                break
+            elif enabled[-1] and line.startswith('TASK_'):
+                name = line.rstrip(',')
+                if name != 'TASK_COUNT':
+                    names.append(name[len('TASK_'):].lower())
+    return names
+
+
+def records(lines):
+    # (event, arg, ms, cycles) of every "T" line, in order
+    pattern = re.compile(r'^T((?:[0-9A-F]{12})+)$')
+    for line in lines:
+        m = pattern.match(line.strip())
+        if not m:
+            continue
+        data = bytes.fromhex(m.group(1))
+        for i in range(0, len(data), 6):
+            yield (data[i], data[i + 1], data[i + 2] << 8 | data[i + 3],
+                   data[i + 4] << 8 | data[i + 5])
+
+
+def timestamps(recs):
+    # Extend 16-bit milliseconds to microseconds since the first record;
+    # records taken while the tick ISR is pending are 1 ms behind, which
+    # is told by going back in time against the order of records
+    ms = None
+    prev = 0.0
+    for event, arg, ms16, cycles in recs:
+        if ms is None:
+            ms = ms16
+        else:
+            delta = (ms16 - ms) & 0xffff
+            if delta >= 0x8000:
+                delta -= 0x10000
+            ms += delta
+        t = ms * 1000.0 + cycles / CYCLES_PER_US
+        if t < prev:
+            t += 1000.0
+        prev = t
+        yield t, event, arg
+
+
+def decode(recs, tasks):
+    events = []
+    open_task = None
+    open_twi = None
+    t0 = None
+
+    def instant(track, t, name, args=None, scope='t'):
+        events.append({'name': name, 'ph': 'i', 's': scope, 'pid': 0,
+                       'tid': TRACKS[track], 'ts': t - t0,
+                       'args': args or {}})
+
+    def complete(track, begin, end, name, args=None):
+        events.append({'name': name, 'ph': 'X', 'pid': 0,
+                       'tid': TRACKS[track], 'ts': begin - t0,
+                       'dur': end - begin, 'args': args or {}})
+
+    for t, event, arg in timestamps(recs):
+        if t0 is None:
+            t0 = t
+        kind = EVENTS[event] if event < len(EVENTS) else 'unknown'
+        if kind == 'task_begin':
+            # A begin with no end before it had the end lost
+            open_task = (t, arg)
+        elif kind == 'task_end':
+            if open_task and open_task[1] == arg:
+                name = tasks[arg] if arg < len(tasks) else str(arg)
+                complete('task', open_task[0], t, name)
+            open_task = None
+        elif kind in ('timer0', 'timer1', 'usart_rx', 'usart_udre'):
+            instant('isr', t, kind.upper(), {'arg': arg})
+        elif kind == 'state':
+            instant('state', t, 'state 0x{:02x}'.format(arg))
+        elif kind == 'twi_start':
+            # Repeated starts are in the same transaction
+            if open_twi is None:
+                open_twi = (t, [])
+            open_twi[1].append('0x{:02x} {}'.format(
+                arg >> 1, 'R' if arg & 0x01 else 'W'))
+        elif kind == 'twi_stop':
+            if open_twi:
+                complete('twi', open_twi[0], t, 'TWI ' + open_twi[1][0],
+                         {'addresses': open_twi[1]})
+            open_twi = None
+        elif kind == 'overflow':
+            name = BUFFERS[arg] if arg < len(BUFFERS) else str(arg)
+            instant('trace', t, 'overflow ' + name, scope='g')
+        elif kind == 'lost':
+            instant('trace', t, 'lost {}'.format(arg), {'count': arg})
+            open_task = None
+            open_twi = None
+        else:
+            instant('trace', t, 'unknown {}'.format(event), {'arg': arg})
+    for name, tid in TRACKS.items():
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': 0,
+                       'tid': tid, 'args': {'name': name}})
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a firmware trace.')
+    parser.add_argument('-D', dest='defines', action='append', default=[],
+                        help='macro defined in the firmware build')
+    parser.add_argument('-o', '--output', help='trace JSON (default stdout)')
+    parser.add_argument('capture', nargs='?', help='serial capture')
+    args = parser.parse_args()
+
+    # The firmware drains the trace only with TRACE defined
+    tasks = task_names(SCHED_H, set(args.defines) | {'TRACE'})
+    if args.capture:
+        with open(args.capture, errors='replace') as f:
+            events = decode(records(f), tasks)
+    else:
+        events = decode(records(sys.stdin), tasks)
+    out = open(args.output, 'w') if args.output else sys.stdout
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ms'}, out)
+    out.write('\n')
+
+
+if __name__ == '__main__':
+    main()